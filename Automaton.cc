@@ -1,9 +1,14 @@
 #include "Automaton.h"
+#include "AutomatonFile.h"
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <string>
 #include <string.h> 
-/*********  main start at line 825, rules writting at line 885   ************************/
+#include "InclusionEncoder.h"
+#include "Matcher.h"
+#include "SatSolver.h"
+/*********  main is at the end of the file, the clauses are written by InclusionEncoder   ************************/
 namespace fa{
   Automaton::Automaton() { 
     
@@ -18,6 +23,7 @@ namespace fa{
       return false; 
     }
     this->alphabet.push_back(symbol);
+    changed();
     return true;
   }
 
@@ -27,6 +33,7 @@ namespace fa{
     }
     const size_t orig_size=this->alphabet.size();
     this->alphabet.erase(std::remove(this->alphabet.begin(), this->alphabet.end(), symbol), this->alphabet.end());
+    changed();
     return (orig_size==this->alphabet.size()+1);
   }
 
@@ -39,24 +46,59 @@ namespace fa{
   }
 
   bool Automaton::addState(int state){
+    //reuse the index of a removed state before growing the bitsets
+    const int index=freeIndices.empty() ? initials.size() : freeIndices.back();
     std::pair<std::map<int,int>::iterator,bool> ret;
-    ret = etats.insert(std::pair<int,int>(state,0));
+    ret = etats.insert(std::pair<int,int>(state,index));
+    if(ret.second){
+      changed();
+      if(freeIndices.empty()){
+        initials.resize(initials.size()+1);
+        finals.resize(finals.size()+1);
+        indexNames.push_back(state);
+      }else{
+        freeIndices.pop_back();
+        indexNames[index]=state;
+      }
+    }
     return(ret.second);
   }
 
   bool Automaton::removeState(int state){
-    if(etats.erase(state)!=0){
-      //erase the transitions from state
-      transis.erase(state);
-      //erase the transitions to state
-      std::map<int,std::multimap<char,int>>::iterator itOnStates;
-      for(itOnStates=transis.begin();itOnStates!=transis.end();++itOnStates){
-        for(std::multimap<char,int>::iterator itOnChars=itOnStates->second.begin();itOnChars!=itOnStates->second.begin();++itOnChars){
+    std::map<int,int>::iterator found=etats.find(state);
+    if(found!=etats.end()){
+      changed();
+      initials.reset(found->second);
+      finals.reset(found->second);
+      freeIndices.push_back(found->second);
+      //erase the transitions to state, only its predecessors have some
+      const std::set<int>& predecessors=statesToState(this,state);
+      for(int from : predecessors){
+        std::map<int,std::multimap<char,int>>::iterator itOnStates=transis.find(from);
+        if(itOnStates==transis.end()){
+          continue;
+        }
+        for(std::multimap<char,int>::iterator itOnChars=itOnStates->second.begin();itOnChars!=itOnStates->second.end();){
           if(itOnChars->second==state){
-            transis.at(itOnStates->first).erase(itOnChars);
+            itOnChars=itOnStates->second.erase(itOnChars);
+          }else{
+            ++itOnChars;
           }
         }
       }
+      etats.erase(found);
+      //erase the transitions from state, and state from the predecessors of its successors
+      std::map<int,std::multimap<char,int>>::iterator itFrom=transis.find(state);
+      if(itFrom!=transis.end()){
+        for(std::multimap<char,int>::const_iterator itOnChars=itFrom->second.begin();itOnChars!=itFrom->second.end();++itOnChars){
+          if(itOnChars->second!=state){
+            reverseTransis[itOnChars->second].erase(state);
+          }
+        }
+        transis.erase(itFrom);
+      }
+      //statesToState above left the index valid
+      reverseTransis.erase(state);
       return true;
     }
     return false;
@@ -71,51 +113,34 @@ namespace fa{
   }
 
   void Automaton::setStateInitial(int state){
-    if(hasState(state)){
-      auto it=etats.begin();
-      while(it->first!=state){
-        ++it;
-      }
-      //state isn't initial
-      if(!isStateInitial(state)){
-        ++it->second;
-      }
+    std::map<int,int>::const_iterator it=etats.find(state);
+    if(it!=etats.end()){
+      initials.set(it->second);
+      changed();
     }
   }
 
   bool Automaton::isStateInitial(int state)const{
-    if(hasState(state)){
-      auto it=etats.begin();
-      while(it->first!=state){
-        ++it;
-      }
-      return (it->second%2==1);
-    }
-    return false;
+    std::map<int,int>::const_iterator it=etats.find(state);
+    return (it!=etats.end() && initials.test(it->second));
   }
 
   void Automaton::setStateFinal(int state){
-    if(hasState(state)){
-      auto it=etats.begin();
-      while(it->first!=state){
-        ++it;
-      }
-      //state isn't initial
-      if(!isStateFinal(state)){
-        it->second+=2;
-      }
+    std::map<int,int>::const_iterator it=etats.find(state);
+    if(it!=etats.end()){
+      finals.set(it->second);
+      changed();
     }
   }
 
   bool Automaton::isStateFinal(int state)const{
-    if(hasState(state)){
-      auto it=etats.begin();
-      while(it->first!=state){
-        ++it;
-      }
-      return (it->second>=2);
-    }
-    return false;
+    std::map<int,int>::const_iterator it=etats.find(state);
+    return (it!=etats.end() && finals.test(it->second));
+  }
+
+  std::size_t Automaton::countInitialStates() const{
+    //removed states have their flags cleared
+    return initials.count();
   }
 
   bool Automaton::addTransition(int from, char alpha, int to){
@@ -135,6 +160,10 @@ namespace fa{
     }
     before=transis[from].size();
     transis[from].insert(std::pair<char,int>(alpha,to));
+    changed();
+    if(reverseValid){
+      reverseTransis[to].insert(from);
+    }
     return(transis[from].size()==before+1);
   }
 
@@ -142,6 +171,7 @@ namespace fa{
     if(!hasTransition(from,alpha,to)){
       return false;
     }
+    changed();
     std::pair<std::multimap<char,int>::const_iterator,std::multimap<char,int>::const_iterator>result=transis.at(from).equal_range(alpha);
     for(std::multimap<char,int>::const_iterator it=result.first;it!=result.second;++it){
       if(it->second==to){
@@ -149,6 +179,17 @@ namespace fa{
         break;
       }
     }
+    //from stays a predecessor of to if it can still reach it with another symbol
+    if(reverseValid){
+      const std::multimap<char,int>& onChars=transis.at(from);
+      bool stillPredecessor=false;
+      for(std::multimap<char,int>::const_iterator it=onChars.begin();it!=onChars.end() && !stillPredecessor;++it){
+        stillPredecessor=it->second==to;
+      }
+      if(!stillPredecessor){
+        reverseTransis[to].erase(from);
+      }
+    }
     return(!hasTransition(from,alpha,to));
   }
 
@@ -185,14 +226,14 @@ namespace fa{
     printf("Initial States :\n\t");
     std::map<int,int>::const_iterator it;
     for(it=etats.begin();it!=etats.end();++it){
-      if(it->second%2==1){
+      if(initials.test(it->second)){
         printf("%d ",it->first);
       }
     }
     //final states
     printf("\nInitial States :\n\t");
     for(it=etats.begin();it!=etats.end();++it){
-      if(it->second>1){
+      if(finals.test(it->second)){
         printf("%d ",it->first);
       }
     }
@@ -221,7 +262,7 @@ namespace fa{
     std::map<int,int>::const_iterator it;
     printf("node [shape = doublecircle];");
     for(it=etats.begin();it!=etats.end();++it){
-      if(it->second>1){
+      if(finals.test(it->second)){
         printf("%d ",it->first);
       }
     }
@@ -230,7 +271,7 @@ namespace fa{
 
     //initial states
     for(it=etats.begin();it!=etats.end();++it){
-      if(it->second%2==1){
+      if(initials.test(it->second)){
         printf("initArrow%d [label= \"\", shape=none,height=.0,width=.0]\n",it->first);
         printf("initArrow%d -> %d\n",it->first,it->first);
       }
@@ -267,11 +308,7 @@ namespace fa{
       return true;
     }
     //One and only one initial state
-    int numOfInit=0;
-    for(std::map<int,int>::const_iterator it=etats.begin();it!=etats.end();++it){
-      numOfInit+=(it->second%2==1);
-    }
-    if(numOfInit!=1){
+    if(countInitialStates()!=1){
       return false;
     }
 
@@ -302,231 +339,128 @@ namespace fa{
     return true;
   }
 
-  /**
-     * Browse the automaton to remove the Non-accessbile states
-     */
-    void Automaton::DepthSearchRemove(std::_Rb_tree_iterator<std::pair<const int, int>>& s,std::set<int>& visit){
-      visit.insert(s->first);
-      auto tr=transis.at(s->first).begin();
-      while(tr!=transis.at(s->first).end()) {
-        if(tr->second==s->first){ //if the transition is in the current state, we have already tested if the state was final.
-          tr++;
-          if(tr==transis.at(s->first).end()){
-            break;
+  int Automaton::search(Traversal& traversal,bool backward,const Bitset *targets) const{
+    return traversal.run([&](int s,const auto& add){
+      if(backward){
+        for(int from : statesToState(this,indexNames[s])){
+          std::map<int,int>::const_iterator found=etats.find(from);
+          if(found!=etats.end()){
+            add(found->second);
           }
         }
-        auto si = etats.find(tr->second);
-        if(visit.find(si->first)==visit.end()){
-          DepthSearchRemove(si,visit);
-        }
-        tr++;
-      }
-    }
-
-  void Automaton::removeNonAccessibleStates(){
-    //vector containing the accessible states
-    // std::set<int> accessibleStates;
-    // //depth first search from each initial state
-    // for(std::map<int,int>::const_iterator itStates=etats.begin();itStates!=etats.end();++itStates){
-    //   //if Initial and not already visited
-    //   if(itStates->second%2==1 && accessibleStates.find(itStates->second)==accessibleStates.end()){
-    //     depthSearchAccessibles(this,accessibleStates,itStates->first);
-    //   }
-    // }
-
-    // std::map<int,int>::const_iterator it=etats.begin();
-    // while(it!=etats.end()){
-    //   if(std::find(accessibleStates.begin(),accessibleStates.end(),it->first)==accessibleStates.end()){
-    //     int toRemove=it->first;
-    //     ++it;
-    //     removeState(toRemove);
-    //   }else{
-    //     ++it;
-    //   }
-    // }
-
-    if(!isValid()){
         return;
       }
-      std::set<int> visit;
-      auto s=etats.begin();
-      while(s!=etats.end()){
-        if(isStateInitial(s->first)){
-          DepthSearchRemove(s,visit);
-        }
-        s++;
+      std::map<int,std::multimap<char,int>>::const_iterator itTransis=transis.find(indexNames[s]);
+      if(itTransis==transis.end()){
+        return;
       }
-      s=etats.begin();
-      while(s!=etats.end()){
-        if(visit.find(s->first)==visit.end()){
-          s=etats.erase(s);
-          //Pas besoin de s'occuper des transitions qui viennent à lui puisque soit il n'y en a pas, soit elles proviennent d'un état poubelle qui sera également supprimé
-        }else{
-          s++;
+      for(std::multimap<char,int>::const_iterator itOnChars=itTransis->second.begin();itOnChars!=itTransis->second.end();++itOnChars){
+        std::map<int,int>::const_iterator found=etats.find(itOnChars->second);
+        if(found!=etats.end()){
+          add(found->second);
         }
       }
-      if(!isValid()){
-        //addState(0);
-      }
+    },[targets](int s){
+      return targets!=nullptr && targets->test(s);
+    });
   }
 
-
-  void Automaton::depthSearchAccessibles(const Automaton *automaton,std::set<int> &accessibleStates,int state){
-    accessibleStates.insert(state);
-    std::set<int> to =statesFromState(automaton,state);
-    for(std::set<int>::const_iterator it=to.begin();it!=to.end();++it){
-      if(accessibleStates.insert(*it).second){
-        depthSearchAccessibles(automaton,accessibleStates,*it);
+  void Automaton::removeStatesOutside(const Bitset& keep){
+    std::map<int,int>::iterator s=etats.begin();
+    while(s!=etats.end()){
+      if(!keep.test(s->second)){
+        transis.erase(s->first);
+        s=etats.erase(s);
+      }else{
+        ++s;
       }
     }
-  }
-
-  /*
-  For a given state, returns a set containing all states that are accessible within a single move
-  */
-  std::set<int> Automaton::statesFromState(const Automaton *automaton,int from){
-    std::set<int>accessibleStates;
-    for(std::multimap<char,int>::const_iterator it=automaton->transis.at(from).begin();it!=automaton->transis.at(from).end();++it){
-      if (std::find(accessibleStates.begin(),accessibleStates.end(), it->second) == accessibleStates.end()){
-        accessibleStates.insert(it->second);
-      }
+    //number the kept states 0..n-1 again, the bitsets shrink to the new size
+    Bitset keptInitials(etats.size());
+    Bitset keptFinals(etats.size());
+    indexNames.resize(etats.size());
+    int index=0;
+    for(std::map<int,int>::iterator it=etats.begin();it!=etats.end();++it,++index){
+      if(initials.test(it->second)){
+        keptInitials.set(index);
+      }
+      if(finals.test(it->second)){
+        keptFinals.set(index);
+      }
+      it->second=index;
+      indexNames[index]=it->first;
     }
-    return accessibleStates;
-  }
-
-  /*
-  For a given state, returns a set containing all states that are accessible within a single move using a given letter
-  */
-  std::set<int> statesFromStateLetter(const Automaton *automaton,int from,char c){
-    std::set<int>accessibleStates;
-    for(std::map<int,int>::const_iterator to=automaton->etats.begin();to!=automaton->etats.end();++to){
-      if(automaton->hasTransition(from,c,to->first)){
-        accessibleStates.insert(to->first);
+    initials=keptInitials;
+    finals=keptFinals;
+    freeIndices.clear();
+    //the kept states can have transitions to the removed ones
+    for(std::map<int,std::multimap<char,int>>::iterator itOnStates=transis.begin();itOnStates!=transis.end();++itOnStates){
+      for(std::multimap<char,int>::iterator itOnChars=itOnStates->second.begin();itOnChars!=itOnStates->second.end();){
+        if(!hasState(itOnChars->second)){
+          itOnChars=itOnStates->second.erase(itOnChars);
+        }else{
+          ++itOnChars;
+        }
       }
     }
-    return accessibleStates;
+    reverseValid=false;
+    changed();
   }
 
-  /**
-     * Browse the automaton to check if the language is empty
-     * Or check if a state can join a final state
-     */
-    bool Automaton::DepthSearchEmpty(std::_Rb_tree_iterator<std::pair<const int, int>>& s,std::set<int>& visit){
-      visit.insert(s->first);
-      auto tr=transis.at(s->first).begin();
-      while(tr!=transis.at(s->first).end()){
-        if(tr->second==s->first){ //if the transition is in the current state, we have already tested if the state was final.
-          tr++;
-          if(tr==transis.at(s->first).end()){
-            break;
-          }
-        }
-        auto si = etats.find(tr->second);
-        if(isStateFinal(si->first)){
-          return false;
-        }
-        if(visit.find(si->first)==visit.end()){
-          if(DepthSearchEmpty(si,visit)==false){
-            return false;
-          }
-        }
-        tr++;
-      }
-      return true;
+  void Automaton::removeNonAccessibleStates(){
+    if(!isValid()){
+      return;
     }
+    Traversal traversal(initials.size());
+    for(std::size_t s=initials.first();s<initials.size();s=initials.next(s+1)){
+      traversal.addSource(s);
+    }
+    search(traversal,false,nullptr);
+    removeStatesOutside(traversal.visited());
+  }
 
   void Automaton::removeNonCoAccessibleStates(){
-    //vector containing the accessible states
-    // std::set<int> coAccessibleStates;
-    // //depth first search from each initial state
-    // for(std::map<int,int>::const_iterator itStates=etats.begin();itStates!=etats.end();++itStates){
-    //   //if Initial and not already visited
-    //   if(itStates->second>1 && coAccessibleStates.find(itStates->second)==coAccessibleStates.end()){
-    //     depthSearchCoAccessibles(this,coAccessibleStates,itStates->first);
-    //   }
-    // }
-
-    // std::map<int,int>::const_iterator it=etats.begin();
-    // while(it!=etats.end()){
-    //   if(std::find(coAccessibleStates.begin(),coAccessibleStates.end(),it->first)==coAccessibleStates.end()){
-    //     int toRemove=it->first;
-    //     ++it;
-    //     removeState(toRemove);
-    //   }else{
-    //     ++it;
-    //   }
-    // }
-
     if(!isValid()){
-        return;
-      }
-      std::set<int> visit;
-      auto s=etats.begin();
-      while(s!=etats.end()){
-        if(!isStateFinal(s->first)){
-          if(DepthSearchEmpty(s,visit)){
-            auto temp=s;
-            s++;
-            removeState(temp->first);
-          }else{
-            s++;
-          }
-        }else{
-          s++;
-        }
-        visit.clear();
-      }
-      if(!isValid()){
-       // addState(0);
-      }
-  }
-
-  void Automaton::depthSearchCoAccessibles(const Automaton *automaton,std::set<int> &coAccessibleStates,int state){
-    //printf("\n%d",state);
-    coAccessibleStates.insert(state);
-    std::set<int> to =statesToState(automaton,state);
-    for(std::set<int>::const_iterator it=to.begin();it!=to.end();++it){
-      if(coAccessibleStates.insert(*it).second){
-        depthSearchCoAccessibles(automaton,coAccessibleStates,*it);
-      }
+      return;
     }
+    //one backward search from all the final states
+    Traversal traversal(finals.size());
+    for(std::size_t s=finals.first();s<finals.size();s=finals.next(s+1)){
+      traversal.addSource(s);
+    }
+    search(traversal,true,nullptr);
+    removeStatesOutside(traversal.visited());
   }
 
   /*
-  For a given state, returns a set containing all states that can access the state within a single move
+  For a given state, returns the set of all states that can access the state within a single move
   */
-  std::set<int> Automaton::statesToState(const Automaton *automaton,int to){
-    std::set<int>coAccessibleStates;
-    for(std::map<int,std::multimap<char,int>>::const_iterator itTransis=automaton->transis.begin();itTransis!=automaton->transis.end();++itTransis){
-      for(std::multimap<char,int>::const_iterator itOnChars=itTransis->second.begin();itOnChars!=itTransis->second.end();++itOnChars){
-        if(itOnChars->second==to){
-          coAccessibleStates.insert(itTransis->first);
+  const std::set<int>& Automaton::statesToState(const Automaton *automaton,int to){
+    if(!automaton->reverseValid){
+      automaton->reverseTransis.clear();
+      for(std::map<int,std::multimap<char,int>>::const_iterator itTransis=automaton->transis.begin();itTransis!=automaton->transis.end();++itTransis){
+        //transitions of removed states may still be stored
+        if(!automaton->hasState(itTransis->first)){
+          continue;
+        }
+        for(std::multimap<char,int>::const_iterator itOnChars=itTransis->second.begin();itOnChars!=itTransis->second.end();++itOnChars){
+          automaton->reverseTransis[itOnChars->second].insert(itTransis->first);
         }
       }
+      automaton->reverseValid=true;
     }
-    return coAccessibleStates;
+    static const std::set<int> none;
+    std::map<int,std::set<int>>::const_iterator found=automaton->reverseTransis.find(to);
+    return found==automaton->reverseTransis.end() ? none : found->second;
   }
 
   bool Automaton::isLanguageEmpty() const{
-    //Get all states accessible from initial states, then check if there is at least one that is final
-
-    //vector containing the accessible states
-    std::set<int> accessibleStates;
-    //depth first search from each initial state
-    for(std::map<int,int>::const_iterator itStates=etats.begin();itStates!=etats.end();++itStates){
-      //if Initial and not already visited
-      if(itStates->second%2==1 && accessibleStates.find(itStates->second)==accessibleStates.end()){
-        depthSearchAccessibles(this,accessibleStates,itStates->first);
-      }
-    }
-
-    std::set<int>::const_iterator it;
-    for(it=accessibleStates.begin();it!=accessibleStates.end();++it){
-      if(isStateFinal(*it)){
-        return false;
-      }
+    //search from the initial states, stopped at the first final state
+    Traversal traversal(initials.size());
+    for(std::size_t s=initials.first();s<initials.size();s=initials.next(s+1)){
+      traversal.addSource(s);
     }
-    return true;
+    return search(traversal,false,&finals)<0;
   }
 
   Automaton Automaton::createComplete(const Automaton& automaton){
@@ -639,82 +573,163 @@ namespace fa{
     return result;
   }
 
+  bool Automaton::isIncludedIn(const Automaton& other) const{
+    return isIncludedIn(other,InclusionEngine::Complement);
+  }
+
+  bool Automaton::isIncludedIn(const Automaton& other,InclusionEngine engine) const{
+    return isIncluded(frozen(),other.frozen(),engine);
+  }
+
+  bool Automaton::isEquivalentTo(const Automaton& other) const{
+    return isEquivalentHkc(frozen(),other.frozen());
+  }
+
+  bool Automaton::findCounterexample(const Automaton& other,std::string& word) const{
+    return fa::findCounterexample(frozen(),other.frozen(),word);
+  }
+
+  std::set<int> Automaton::readString(const std::string& word) const{
+    const FrozenAutomaton& automaton=frozen();
+    const Bitset reached=automaton.readString(word);
+    std::set<int> res;
+    for(std::size_t s=reached.first();s<reached.size();s=reached.next(s+1)){
+      res.insert(res.end(),automaton.stateName(s));
+    }
+    return res;
+  }
+
+  bool Automaton::match(const std::string& word) const{
+    return matcher().match(word);
+  }
+
+  const Matcher& Automaton::matcher() const{
+    if(!cachedMatcher){
+      cachedMatcher=std::make_shared<Matcher>(frozen());
+    }
+    return *cachedMatcher;
+  }
+
+  const FrozenAutomaton& Automaton::frozen() const{
+    if(!cachedFrozen){
+      cachedFrozen=std::make_shared<const FrozenAutomaton>(freeze());
+    }
+    return *cachedFrozen;
+  }
+
+  void Automaton::changed(){
+    cachedFrozen.reset();
+    cachedMatcher.reset();
+  }
+
+  CompiledDfa Automaton::compile() const{
+    return CompiledDfa(frozen());
+  }
+
+  bool Automaton::save(const std::string& path) const{
+    return saveAutomaton(frozen(),path);
+  }
+
+  bool Automaton::load(const std::string& path,Automaton& automaton){
+    FrozenAutomaton frozen;
+    if(!loadAutomaton(path,frozen)){
+      return false;
+    }
+    automaton=thaw(frozen);
+    //the queries run on the mapped file, the copy in the maps is only for the changes
+    automaton.cachedFrozen=std::make_shared<const FrozenAutomaton>(frozen);
+    return true;
+  }
 
     /**
      * Create a deterministic automaton, if not already deterministic
      */
     Automaton Automaton::createDeterministic(const Automaton& other){
-      Automaton product;
-      product.alphabet=other.alphabet;
-      std::map<int,std::set<int>>tab;
-      std::set<int>dest;
-      product.addState(0);
-      auto s=other.etats.begin();
-      while(s!=other.etats.end()){
-        if(s->second==1){//Initial
-          tab[0].insert(s->first);
+      return thaw(other.frozen().createDeterministic());
+    }
+
+  Automaton Automaton::createMinimalMoore(const Automaton& other){
+    return thaw(other.frozen().createMinimalMoore());
+  }
+
+  Automaton Automaton::createMinimalHopcroft(const Automaton& other){
+    return thaw(other.frozen().createMinimalHopcroft());
+  }
+
+  Automaton Automaton::createMinimalBrzozowski(const Automaton& other){
+    return thaw(other.frozen().createMinimalBrzozowski());
+  }
+
+  Automaton Automaton::createBisimulationQuotient(const Automaton& other){
+    return thaw(other.frozen().createBisimulationQuotient());
+  }
+
+  Automaton Automaton::createSimulationPruned(const Automaton& other){
+    return thaw(other.frozen().createSimulationPruned());
+  }
+
+  FrozenAutomaton Automaton::freeze() const{
+    //the copy shares the arrays of the cache
+    if(cachedFrozen){
+      return *cachedFrozen;
+    }
+    std::vector<int> names;
+    std::vector<unsigned char> flags;
+    names.reserve(etats.size());
+    flags.reserve(etats.size());
+    for(std::map<int,int>::const_iterator it=etats.begin();it!=etats.end();++it){
+      names.push_back(it->first);
+      flags.push_back((initials.test(it->second) ? FrozenAutomaton::Initial : 0) | (finals.test(it->second) ? FrozenAutomaton::Final : 0));
+    }
+    int symbols[256];
+    std::fill(symbols,symbols+256,-1);
+    for(std::size_t i=0;i<alphabet.size();++i){
+      symbols[static_cast<unsigned char>(alphabet[i])]=i;
+    }
+    std::vector<FrozenAutomaton::Edge> edges;
+    edges.reserve(countTransitions());
+    for(std::map<int,std::multimap<char,int>>::const_iterator itTransis=transis.begin();itTransis!=transis.end();++itTransis){
+      std::vector<int>::const_iterator from=std::lower_bound(names.begin(),names.end(),itTransis->first);
+      //transitions of removed states may still be stored
+      if(from==names.end() || *from!=itTransis->first){
+        continue;
+      }
+      for(std::multimap<char,int>::const_iterator itOnChars=itTransis->second.begin();itOnChars!=itTransis->second.end();++itOnChars){
+        std::vector<int>::const_iterator to=std::lower_bound(names.begin(),names.end(),itOnChars->second);
+        const int symbol=symbols[static_cast<unsigned char>(itOnChars->first)];
+        if(to==names.end() || *to!=itOnChars->second || symbol<0){
+          continue;
         }
-        s++;
+        edges.push_back(FrozenAutomaton::Edge{static_cast<int>(from-names.begin()),symbol,static_cast<int>(to-names.begin())});
       }
-      //first state will be initial (build from initial states)
-      product.setStateInitial(0);
+    }
+    return FrozenAutomaton(alphabet,names,flags,edges);
+  }
 
-      if(tab[0].empty()){
-        return product;
+  Automaton Automaton::thaw(const FrozenAutomaton& frozen){
+    Automaton result;
+    result.alphabet=frozen.alphabet();
+    result.initials.resize(frozen.countStates());
+    result.finals.resize(frozen.countStates());
+    for(std::size_t s=0;s<frozen.countStates();++s){
+      result.etats.insert(result.etats.end(),std::pair<int,int>(frozen.stateName(s),s));
+      result.indexNames.push_back(frozen.stateName(s));
+      if(frozen.isInitial(s)){
+        result.initials.set(s);
       }
-      
-      auto it=tab.begin();
-      while(it!=tab.end()){
-        for(size_t i=0;i<product.alphabet.size();++i){
-          
-          int in=0;
-          for(auto s : it->second){
-
-              dest=statesFromStateLetter(&product,s,product.alphabet[i]);
-             
-          }
-        
-        if(!dest.empty()){
-          for(auto it = tab.begin();it!=tab.end();it++){
-            if(it->second==dest){
-              in=1;
-              break;
-            }
-          }
-          int n=-1;
-          if(in==0){
-            int n=tab.size();
-            tab[n]=dest;
-            product.addState(n);
-            product.addTransition(it->first,product.alphabet[i],n);
-          }else{
-            for(auto snb : tab){
-              if(snb.second==dest){
-                n=snb.first;
-              }
-            }
-            product.addTransition(it->first,product.alphabet[i],n);
-          }
-        }
-          
-        
-        dest.clear();
+      if(frozen.isFinal(s)){
+        result.finals.set(s);
       }
-      
-      it++;
     }
-    //Search the final state
-    for(auto e : tab){
-      for(auto s : e.second){
-        if(other.isStateFinal(s)){
-          product.setStateFinal(e.first);
+    for(std::size_t s=0;s<frozen.countStates();++s){
+      for(std::size_t a=0;a<frozen.countSymbols();++a){
+        for(int to : frozen.successors(s,a)){
+          result.transis[frozen.stateName(s)].insert(std::pair<char,int>(frozen.symbol(a),frozen.stateName(to)));
         }
       }
     }
-
-
-      return product;
-    }
+    return result;
+  }
 
 }
 struct transi{
@@ -723,49 +738,6 @@ struct transi{
   int to;
 };
 
-std::string split(std::string str,char delimiter, int posWanted){
-  int actualPos=0;
-  std::string res="";
-  for(std::size_t i=0;i<str.size();++i){
-    if(str.at(i)==delimiter){
-      if(actualPos==posWanted){
-        return res;
-      }
-      ++actualPos;
-      res="";
-    }else{
-      res+=str.at(i);
-    }
-  }
-  if(actualPos==posWanted){
-    return res;
-  }
-  return "NOT FOUND";
-}
-
-//automaton : 1 for the one to be included, 2 for the other
-int satValueAutomatons(std::map<std::string,int> tableOfCorrespondances1,int automaton,int state, int step){
-  std::string index="";
-  if(automaton==1){
-    index+="A1 ";
-  }else if(automaton==2){
-    index+="A2 ";
-  }
-  index+=std::to_string(state)+" "+std::to_string(step);
-  return tableOfCorrespondances1[index];
-}
-
-int satValueWord(std::map<std::string,int> tableOfCorrespondances1,char letter,int pos){
-  std::string index="";index.push_back(letter);
-  index+=" "+std::to_string(pos);
-  return tableOfCorrespondances1[index];
-}
-
-void printTable(std::map<std::string,int> table){
-  for(std::map<std::string,int>::const_iterator it=table.begin();it!=table.end();++it){
-    std::cout << it->first << " -> "<< it->second << "\n";
-  }
-}
 /*
 Création d'automate random 
 */
@@ -785,15 +757,15 @@ fa::Automaton RandomAutomaton(int nbstates){
     res.addState(i);
     fich << "A2.addState("<<i<<");"<<"\n";
   }
-  for(auto s : res.etats){
-    for(auto ss : res.etats){
+  for(int s=0;s<nbstates;++s){
+    for(int ss=0;ss<nbstates;++ss){
       for(char c : letter){
         double rand1 = rand() / (double)RAND_MAX;
         
         if(rand1 < 1.6/nbstates){
           //printf("\ndouble : %f\n",rand1);
-          res.addTransition(s.first,c,ss.first);
-          fich << "A2.addTransition("<<s.first<<",'"<<c<<"',"<<ss.first<<");"<<"\n";
+          res.addTransition(s,c,ss);
+          fich << "A2.addTransition("<<s<<",'"<<c<<"',"<<ss<<");"<<"\n";
         }
       }
     }
@@ -819,10 +791,274 @@ fa::Automaton RandomAutomaton(int nbstates){
   return res;
 }
 
+/*
+A2 of a run: mapped from loadPath if it is set, random otherwise, then written to savePath if it is set.
+A2 is only read, it stays frozen (a mapped file is never copied)
+*/
+bool createA2(int nbStates,const std::string& loadPath,const std::string& savePath,fa::FrozenAutomaton& A2){
+  if(loadPath.empty()){
+    A2=RandomAutomaton(nbStates).freeze();
+  }else if(!fa::loadAutomaton(loadPath,A2)){
+    std::cout << "Error, cannot load " << loadPath << "\n";
+    return false;
+  }
+  if(!savePath.empty() && !fa::saveAutomaton(A2,savePath)){
+    std::cout << "Error, cannot write " << savePath << "\n";
+    return false;
+  }
+  return true;
+}
+
+
+/*
+Comment written in a CNF of the --SAT mode: what the numbering of the letter variables depends on,
+read back by readEncodingComment to decode the model
+*/
+std::string encodingComment(const fa::InclusionEncoder& encoder,fa::LetterEncoding letters,const std::string& amoName){
+  return "fa-encoding length="+std::to_string(encoder.getLength())+" alphabet="+std::string(encoder.alphabet().begin(),encoder.alphabet().end())
+    +" letters="+(letters==fa::LetterEncoding::Logarithmic ? "log" : "onehot")+" amo="+amoName;
+}
+
+/*
+Read the encoding comment among the first comment lines of a CNF. Returns false if there is none or it is not valid
+*/
+bool readEncodingComment(const std::string& path,int& length,std::vector<char>& alphabet,fa::LetterEncoding& letters,fa::AmoEncoding& amo){
+  std::ifstream file(path.c_str());
+  std::string line;
+  while(std::getline(file,line) && line.find_first_not_of(' ')!=std::string::npos && (line[0]=='c' || line[0]=='p')){
+    std::istringstream fields(line);
+    std::string field;
+    if(!(fields >> field) || field!="c" || !(fields >> field) || field!="fa-encoding"){
+      continue;
+    }
+    int found=0;
+    while(fields >> field){
+      const std::size_t equal=field.find('=');
+      const std::string key=field.substr(0,equal);
+      const std::string value=equal==std::string::npos ? "" : field.substr(equal+1);
+      if(key=="length"){
+        length=atoi(value.c_str());
+        found|=1;
+      }else if(key=="alphabet"){
+        alphabet.assign(value.begin(),value.end());
+        found|=2;
+      }else if(key=="letters" && (value=="onehot" || value=="log")){
+        letters=value=="log" ? fa::LetterEncoding::Logarithmic : fa::LetterEncoding::OneHot;
+        found|=4;
+      }else if(key=="amo" && fa::parseAmoEncoding(value,amo)){
+        found|=8;
+      }
+    }
+    return found==15 && length>0 && !alphabet.empty();
+  }
+  return false;
+}
 
+/*
+Bounded search of a word accepted by A1 and not by A2, from length minLength to maxLength.
+Each length encodes one more step (the lengths below minLength are encoded but not solved): the clauses of the previous steps and the learnt clauses are kept.
+Only the final state constraints depend on the length, they are guarded by an activation variable
+given to the solver as an assumption, then disabled once the length is refuted.
+With trimStates, the states that cannot be on a run of at most maxLength letters are not encoded.
+Returns the length of the word found, -1 if there is none up to maxLength.
+*/
+int solveIncremental(const fa::FrozenAutomaton& A1,const fa::FrozenAutomaton& A2,int minLength,int maxLength,fa::AmoEncoding encoding,fa::LetterEncoding letters,bool trimStates,fa::CdclSolver& solver,std::string& word){
+  //numbering for the longest word, the activation variables come after
+  fa::InclusionEncoder encoder(A1,A2,maxLength,encoding,letters);
+  if(trimStates){
+    //the word can end before maxLength
+    encoder.trim(false);
+  }
+  solver.reserveVariables(encoder.countVariables()+maxLength+1);
+  for(int length=0;length<=maxLength;++length){
+    encoder.encodeStep(solver,length);
+    if(length<minLength){
+      continue;
+    }
+    const int active=encoder.countVariables()+length+1;
+    encoder.encodeEnd(solver,length,active);
+    if(solver.solve({active})){
+      word=encoder.decodeWord(solver,length);
+      return length;
+    }
+    solver.addClause({-active});
+  }
+  return -1;
+}
 
 using namespace std;
 int main(int argc, char **argv){
+  //options start with "--" and can be anywhere : --amo=pairwise|sequential|commander|product|binary|bimander --letters=onehot|log --no-trim --no-reduce
+  //--load-a2=FILE takes A2 from a binary file instead of a random one, --save-a2=FILE writes A2 to a binary file
+  //--engine=complement|antichain|hkc : inclusion algorithm of --INCLUSION (complement by default)
+  //exit status : 1 when --SOLVE, --INCREMENTAL or the decoding of Automaton.out find A1 included in A2, 2 on error, 0 otherwise
+  fa::AmoEncoding amo=fa::AmoEncoding::Pairwise;
+  std::string amoName="pairwise";
+  fa::LetterEncoding letterEncoding=fa::LetterEncoding::OneHot;
+  bool trimStates=true;
+  bool reduceStates=true;
+  std::string loadA2;
+  std::string saveA2;
+  fa::InclusionEngine engine=fa::InclusionEngine::Complement;
+  std::vector<char*> args;
+  for(int i=0;i<argc;++i){
+    if(strncmp(argv[i],"--amo=",6)==0){
+      if(!fa::parseAmoEncoding(argv[i]+6,amo)){
+        std::cout << "Error, unknown at-most-one encoding " << argv[i]+6 << "\n";
+        return 2;
+      }
+      amoName=argv[i]+6;
+    }else if(strcmp(argv[i],"--letters=onehot")==0){
+      letterEncoding=fa::LetterEncoding::OneHot;
+    }else if(strcmp(argv[i],"--letters=log")==0){
+      letterEncoding=fa::LetterEncoding::Logarithmic;
+    }else if(strncmp(argv[i],"--letters=",10)==0){
+      std::cout << "Error, unknown letter encoding " << argv[i]+10 << "\n";
+      return 2;
+    }else if(strcmp(argv[i],"--no-trim")==0){
+      trimStates=false;
+    }else if(strcmp(argv[i],"--no-reduce")==0){
+      reduceStates=false;
+    }else if(strncmp(argv[i],"--engine=",9)==0){
+      if(!fa::parseInclusionEngine(argv[i]+9,engine)){
+        std::cout << "Error, unknown inclusion engine " << argv[i]+9 << "\n";
+        return 2;
+      }
+    }else if(strncmp(argv[i],"--load-a2=",10)==0){
+      loadA2=argv[i]+10;
+    }else if(strncmp(argv[i],"--save-a2=",10)==0){
+      saveA2=argv[i]+10;
+    }else{
+      args.push_back(argv[i]);
+    }
+  }
+  argc=args.size();
+  argv=args.data();
+
+  /**********   --WITNESS nbStates (seed) : shortest word of A1 not in A2, without SAT solver     ***********/
+  if(argc>1 && strcmp(argv[1],"--WITNESS")==0){
+    int nbStates=10;
+    if(argc>2){
+      nbStates=stoi(argv[2]);
+    }
+    srand(25);
+    fa::Automaton A1=RandomAutomaton(20);
+    if(argc>3){
+      srand(atoi(argv[3]));
+    }else{
+      srand(time(NULL));
+    }
+    fa::FrozenAutomaton A2;
+    if(!createA2(nbStates,loadA2,saveA2,A2)){
+      return 2;
+    }
+    std::string word;
+    if(fa::findCounterexample(A1.freeze(),A2,word)){
+      std::cout << word << "\n" << "A1 is not included in A2\n";
+    }else{
+      std::cout << "A1 is included in A2\n";
+    }
+    return 0;
+  }
+
+  /**********   --INCLUSION nbStates (seed) : is A1 included in A2, with the engine of --engine     ***********/
+  /**********   --EQUIVALENT nbStates (seed) : do A1 and A2 accept the same language (HKC)     ***********/
+  if(argc>1 && (strcmp(argv[1],"--INCLUSION")==0 || strcmp(argv[1],"--EQUIVALENT")==0)){
+    int nbStates=10;
+    if(argc>2){
+      nbStates=stoi(argv[2]);
+    }
+    srand(25);
+    fa::Automaton A1=RandomAutomaton(20);
+    if(argc>3){
+      srand(atoi(argv[3]));
+    }else{
+      srand(time(NULL));
+    }
+    fa::FrozenAutomaton A2;
+    if(!createA2(nbStates,loadA2,saveA2,A2)){
+      return 2;
+    }
+    if(strcmp(argv[1],"--EQUIVALENT")==0){
+      std::cout << (fa::isEquivalentHkc(A1.freeze(),A2) ? "A1 is equivalent to A2\n" : "A1 is not equivalent to A2\n");
+      return 0;
+    }
+    std::cout << (fa::isIncluded(A1.freeze(),A2,engine) ? "A1 is included in A2\n" : "A1 is not included in A2\n");
+    return 0;
+  }
+
+  /**********   --SOLVE length nbStates (seed) : same clauses as --SAT, solved in the process     ***********/
+  if(argc>2 && strcmp(argv[1],"--SOLVE")==0){
+    int length=stoi(argv[2]);
+    int nbStates=10;
+    if(argc>3){
+      nbStates=stoi(argv[3]);
+    }
+    srand(25);
+    fa::Automaton A1=RandomAutomaton(20);
+    if(argc>4){
+      srand(atoi(argv[4]));
+    }else{
+      srand(time(NULL));
+    }
+    fa::FrozenAutomaton A2;
+    if(!createA2(nbStates,loadA2,saveA2,A2)){
+      return 2;
+    }
+    if(reduceStates){
+      //same languages, fewer states to encode
+      A1=fa::Automaton::createSimulationPruned(A1);
+      A2=A2.createBisimulationQuotient();
+    }
+    const fa::FrozenAutomaton frozenA1=A1.freeze();
+    fa::InclusionEncoder encoder(frozenA1,A2,length,amo,letterEncoding);
+    if(trimStates){
+      encoder.trim();
+    }
+    fa::CdclSolver solver;
+    encoder.encode(solver);
+    if(!solver.solve()){
+      std::cout << "A1 is included in A2\n";
+      return 1;
+    }
+    std::cout << encoder.decodeWord(solver,length) << "\n" << "A1 is not included in A2\n";
+    return 0;
+  }
+
+  /**********   --INCREMENTAL maxLength nbStates (seed) : shortest length from 1 with a word of A1 not in A2, one solver for all the lengths     ***********/
+  if(argc>2 && strcmp(argv[1],"--INCREMENTAL")==0){
+    int maxLength=stoi(argv[2]);
+    int nbStates=10;
+    if(argc>3){
+      nbStates=stoi(argv[3]);
+    }
+    srand(25);
+    fa::Automaton A1=RandomAutomaton(20);
+    if(argc>4){
+      srand(atoi(argv[4]));
+    }else{
+      srand(time(NULL));
+    }
+    fa::FrozenAutomaton A2;
+    if(!createA2(nbStates,loadA2,saveA2,A2)){
+      return 2;
+    }
+    if(reduceStates){
+      //same languages, fewer states to encode
+      A1=fa::Automaton::createSimulationPruned(A1);
+      A2=A2.createBisimulationQuotient();
+    }
+    fa::CdclSolver solver;
+    std::string word;
+    //from 1 like the lengths of --SAT and --SOLVE
+    if(solveIncremental(A1.freeze(),A2,1,maxLength,amo,letterEncoding,trimStates,solver,word)<0){
+      std::cout << "A1 is included in A2 up to length " << maxLength << "\n";
+      return 1;
+    }
+    std::cout << word << "\n" << "A1 is not included in A2\n";
+    return 0;
+  }
+
   int length=7;
   if(argc>2){
     length=stoi(argv[2]);
@@ -831,37 +1067,37 @@ int main(int argc, char **argv){
 
   /**********   without argument, get the word that is not included     ***********/
   if(argc<3){
-    if(stoi(argv[1])>0){
-      length=stoi(argv[1]);
+    if(argc>1 && atoi(argv[1])>0){
+      length=atoi(argv[1]);
     }else{
       std::cout<<"Error, need word's number\n";
-      return 1;
+      return 2;
     }
-    std::map<int,int> result;
-    string line;
-    ifstream outFile ("Automaton.out");
-    if (outFile.is_open()){
-      while(getline(outFile,line)){
-        if(line.compare("UNSAT")==0){
-          std::cout << "A1 is included in A2\n";
-          return 1;
-        }
-
-        if(!line.compare("SAT")==0){
-          for(int i=0;i<length;++i){
-            std::string var=split(line,' ',i);
-            if (var.at(0)!='-'){
-              std::cout<<"a";
-            }else{
-              std::cout<<"b";
-            }
-          }
-          std::cout << "\n";
-        }
-      }
-      std::cout << "A1 is not included in A2\n";
-      outFile.close();
+    //letters are numbered first, they only depend on what the --SAT run wrote in the comment of the CNF
+    int cnfLength=0;
+    std::vector<char> symbols;
+    fa::LetterEncoding cnfLetters;
+    fa::AmoEncoding cnfAmo;
+    if(!readEncodingComment("Automaton.cnf",cnfLength,symbols,cnfLetters,cnfAmo)){
+      std::cout << "Error, Automaton.cnf does not give its encoding\n";
+      return 2;
+    }
+    if(cnfLength!=length){
+      std::cout << "Error, Automaton.cnf encodes the words of length " << cnfLength << "\n";
+      return 2;
     }
+    const fa::FrozenAutomaton letters(symbols,std::vector<int>(),std::vector<unsigned char>(),std::vector<fa::FrozenAutomaton::Edge>());
+    const fa::InclusionEncoder encoder(letters,letters,length,cnfAmo,cnfLetters);
+    if(!ifstream("Automaton.out").is_open()){
+      std::cout << "Error, cannot read Automaton.out\n";
+      return 2;
+    }
+    std::vector<bool> model;
+    if(!fa::MinisatProcess::readModel("Automaton.out",model)){
+      std::cout << "A1 is included in A2\n";
+      return 1;
+    }
+    std::cout << encoder.decodeWord(model,length) << "\n" << "A1 is not included in A2\n";
   }else{
     int nbStates=10;
     if(argc>3){
@@ -869,7 +1105,7 @@ int main(int argc, char **argv){
     }
      srand(25);
      fa::Automaton A1=RandomAutomaton(20);
-    if(argc==5){
+    if(argc>4){
       srand(atoi(argv[4]));
     }else{
       srand(time(NULL));
@@ -888,7 +1124,10 @@ int main(int argc, char **argv){
       //  A1.addTransition(0,'b',0);
       // A1.addState(0);A1.addState(1);
       // A1.addState(2);A1.addState(3);
-       fa::Automaton A2=RandomAutomaton(nbStates);
+      fa::FrozenAutomaton A2;
+      if(!createA2(nbStates,loadA2,saveA2,A2)){
+        return 2;
+      }
       /***** A2 for demo ******/
       // fa::Automaton A2;
       // A2.addSymbol('a');A2.addSymbol('b');
@@ -900,174 +1139,37 @@ int main(int argc, char **argv){
       
       // A1.dotPrint(std::cout);
       // A2.dotPrint(std::cout);
-      std::map<std::string,int> tableOfCorrespondances;
-      //index is used to insert elements
-      int tableIndex=1;
-      
-      //clock_t c2 =clock();
-      //Ajout des variables pour representer le mot : a4 = la 4eme lettre du mot est a
-      for(std::vector<char>::const_iterator it=A1.alphabet.begin();it!=A1.alphabet.end();++it){
-        for(int i=1;i<=length;++i){
-          std::string value="";
-          value.push_back(*it);
-          value+=" "+std::to_string(i);
-          tableOfCorrespondances.insert(std::pair<std::string,int>(value,tableIndex));
-          tableIndex++;
-        }
-      }
-      //printf("C2 : %.2fs \n",(double)(clock()-c2)/CLOCKS_PER_SEC);
-
-      //clock_t c3=clock();
-      //Ajout des variables pour representer un etat(A1) a une etape : 2 7 = Le chemin passe par l'etat 2 de A1 a l'etape 7
-      for(std::map<int,int>::const_iterator it=A1.etats.begin();it!=A1.etats.end();it++){
-        for(int i=0;i<=length;++i){
-          std::string value="A1 "+std::to_string(it->first)+" "+std::to_string(i);
-          tableOfCorrespondances.insert(std::pair<std::string,int>(value,tableIndex));
-          tableIndex++;
-        }
-      }
-      //printf("C3 : %.2fs \n",(double)(clock()-c3)/CLOCKS_PER_SEC);
-
-      //clock_t c4=clock();
-      //Ajout des variables pour representer un etat(A2) a une etape : 2 7 = Le chemin passe par l'etat 2 de A1 a l'etape 7
-      for(std::map<int,int>::const_iterator it=A2.etats.begin();it!=A2.etats.end();it++){
-        for(int i=0;i<=length;++i){
-          std::string value="A2 "+std::to_string(it->first)+" "+std::to_string(i);
-          tableOfCorrespondances.insert(std::pair<std::string,int>(value,tableIndex));
-          tableIndex++;
-        }
-      }
-
-      //printf("C4 : %.2fs \n",(double)(clock()-c4)/CLOCKS_PER_SEC);
-
-      ofstream cnfFile;
-      cnfFile.open("Automaton.cnf");
-      cnfFile << "p cnf " << tableIndex << " 0 \n";
-      /**************************Word is in A1*************************************/
-      //clock_t c5=clock();
-      //at each place in the word, only a or only or b
-      for(int i=1;i<=length;++i){
-        std::string index1 ="a "+std::to_string(i);
-        std::string index2 ="b "+std::to_string(i);
-        cnfFile << tableOfCorrespondances[index1] << " " << tableOfCorrespondances[index2] << " 0\n";
-        cnfFile << "-" << tableOfCorrespondances[index1] << " -" <<tableOfCorrespondances[index2] << " 0\n";
-      }
-
-      //Starts with an initial state
-      for(std::map<int,int>::const_iterator state=A1.etats.begin();state!=A1.etats.end();++state){
-        if(A1.isStateInitial(state->first)){
-          std::string index1="A1 "+std::to_string(state->first)+" "+"0";
-          cnfFile << tableOfCorrespondances[index1] << " ";
-        }
-      }
-      cnfFile << "0\n";
-
-      //Ends with a final state
-      for(std::map<int,int>::const_iterator state=A1.etats.begin();state!=A1.etats.end();++state){
-        if(A1.isStateFinal(state->first)){
-          std::string index1="A1 "+std::to_string(state->first)+" "+std::to_string(length);
-          cnfFile << tableOfCorrespondances[index1] << " ";
-        }
-      }
-      cnfFile << "0\n";
-      //printf("C5 : %.2fs \n",(double)(clock()-c5)/CLOCKS_PER_SEC);
-
-      //clock_t c6=clock();
-      //Max one state per step
-      for(int step=0;step<=length;++step){
-        for(size_t state=0;state<A1.countStates()-1;++state){
-          for(size_t state2=state+1;state2<A1.countStates();++state2){
-            std::string index1="A1 "+std::to_string(state)+" "+std::to_string(step);
-            std::string index2="A1 "+std::to_string(state2)+" "+std::to_string(step);
-            cnfFile <<"-"<< tableOfCorrespondances[index1] << " -"<<tableOfCorrespondances[index2]<< " 0\n";
-          }
-        }
-      }
-
-      //At least one state per step
-      for(int step=0;step<=length;++step){
-        for(size_t state=0;state<A1.countStates();++state){
-          std::string index1="A1 "+std::to_string(state)+" "+std::to_string(step);
-          cnfFile << tableOfCorrespondances[index1] << " ";
-        }
-        cnfFile << "0\n";
-      }
-      //printf("C6 : %.2fs \n",(double)(clock()-c6)/CLOCKS_PER_SEC);
-
-      //clock_t c7=clock();
-      //word follows A1's transitions
-      for(std::map<int,int>::const_iterator state=A1.etats.begin();state!=A1.etats.end();++state){
-        std::set<int> destinationsA=statesFromStateLetter(&A1,state->first,'a');
-        std::set<int> destinationsB=statesFromStateLetter(&A1,state->first,'b');
-        for(int step=0;step<length;++step){
-          std::string index1="A1 "+std::to_string(state->first)+" "+std::to_string(step);
-          std::string index2 ="a "+std::to_string(step+1);
-          cnfFile << "-" <<tableOfCorrespondances[index1]<<" -"<<tableOfCorrespondances[index2];
-          for(std::set<int>::const_iterator to=destinationsA.begin();to!=destinationsA.end();to++){
-            std::string index3="A1 "+std::to_string(*to)+" "+std::to_string(step+1);
-            cnfFile << " "<<tableOfCorrespondances[index3];
-          }
-          cnfFile<<" 0\n";
-          std::string index4 ="b "+std::to_string(step+1);
-          cnfFile << "-" <<tableOfCorrespondances[index1]<<" -"<<tableOfCorrespondances[index4];
-          for(std::set<int>::const_iterator to=destinationsB.begin();to!=destinationsB.end();to++){
-            std::string index3="A1 "+std::to_string(*to)+" "+std::to_string(step+1);
-            cnfFile << " "<<tableOfCorrespondances[index3];
-          }
-          cnfFile<<" 0\n";
-        }
-      }
-      //printf("C7 : %.2fs \n",(double)(clock()-c7)/CLOCKS_PER_SEC);
-
-      /**** Rules of A2  ****/
-      //clock_t c8=clock();
-      //Starts with an initial state
-      for(std::map<int,int>::const_iterator state=A2.etats.begin();state!=A2.etats.end();++state){
-        if(A2.isStateInitial(state->first)){
-          // std::string index="A2 ";index+=std::to_string(state->first)+" 0";
-          // cnfFile << tableOfCorrespondances[index] << " ";
-          std::string index="A2 "+std::to_string(state->first)+" 0";
-          cnfFile << tableOfCorrespondances[index] << " 0\n";
-        }
-      }
-     // cnfFile << "0\n";
-      //printf("C8 : %.2fs \n",(double)(clock()-c8)/CLOCKS_PER_SEC);
-
-      //clock_t c9=clock();
-      //Accessible States
-      for(std::map<int,int>::const_iterator state=A2.etats.begin();state!=A2.etats.end();++state){
-        std::set<int> destinationsA=statesFromStateLetter(&A2,state->first,'a');
-        std::set<int> destinationsB=statesFromStateLetter(&A2,state->first,'b');
-        for(int step=0;step<length;step++){
-          for(auto to : destinationsA){
-            std::string index="A2 ";index+=std::to_string(state->first)+" "+std::to_string(step); //satValueAutomatons
-            std::string index2="";index2.push_back('a');index2+=" "+std::to_string(step+1); //satValuWord
-            std::string index3="A2 ";index3+=std::to_string(to)+" "+std::to_string(step+1); //satValueAutomatons
-            cnfFile << "-" <<tableOfCorrespondances[index]<<" -"<<tableOfCorrespondances[index2];
-            cnfFile << " " << tableOfCorrespondances[index3];
-            cnfFile<<" 0\n";
-          }
-          
-          for(auto to : destinationsB){
-            std::string index="A2 ";index+=std::to_string(state->first)+" "+std::to_string(step); //satValueAutomatons
-            std::string index2="";index2.push_back('b');index2+=" "+std::to_string(step+1); //satValueWord
-            std::string index3="A2 ";index3+=std::to_string(to)+" "+std::to_string(step+1); //satValueAutomatons
-            cnfFile << "-" <<tableOfCorrespondances[index]<<" -"<<tableOfCorrespondances[index2];
-            cnfFile << " " << tableOfCorrespondances[index3];
-            cnfFile<<" 0\n";
-          }
-        }
-      }
-      //printf("\nC9 : %.2fs\n",(double)(clock()-c9)/CLOCKS_PER_SEC);
-
-      //clock_t c10=clock();
-      //isNotFinalState
-      for(auto state : A2.etats){
-        if(A2.isStateFinal(state.first)){
-          std::string index= "A2 "+std::to_string(state.first)+" "+std::to_string(length);
-          cnfFile <<" -"<<tableOfCorrespondances[index] << " 0\n";      
-        }
+      if(reduceStates){
+        //same languages, fewer states to encode
+        A1=fa::Automaton::createSimulationPruned(A1);
+        A2=A2.createBisimulationQuotient();
+      }
+      const fa::FrozenAutomaton frozenA1=A1.freeze();
+      fa::InclusionEncoder encoder(frozenA1,A2,length,amo,letterEncoding);
+      if(trimStates){
+        encoder.trim();
+      }
+      //5th argument : output file, compressed if it ends with .gz or .zst
+      const std::string cnfPath=argc>5 ? argv[5] : "Automaton.cnf";
+      bool written;
+      if(fa::DimacsWriter::isCompressed(cnfPath)){
+        //the header is written first, the formula is counted before
+        fa::ClauseCounter counter;
+        encoder.encode(counter);
+        fa::DimacsWriter cnfFile(cnfPath,counter.countVariables(),counter.countClauses());
+        cnfFile.addComment(encodingComment(encoder,letterEncoding,amoName));
+        encoder.encode(cnfFile);
+        written=cnfFile.close();
+      }else{
+        fa::DimacsWriter cnfFile(cnfPath);
+        cnfFile.addComment(encodingComment(encoder,letterEncoding,amoName));
+        encoder.encode(cnfFile);
+        written=cnfFile.close();
+      }
+      if(!written){
+        std::cout << "Error, cannot write " << cnfPath << "\n";
+        return 2;
       }
-      //printf("C10 : %.2fs \n",(double)(clock()-c10)/CLOCKS_PER_SEC);
   }
+  return 0;
 }
\ No newline at end of file
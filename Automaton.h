@@ -9,6 +9,13 @@
 #include <iostream>
 #include <algorithm>
 #include <map>
+#include <memory>
+#include "Bitset.h"
+#include "CompiledDfa.h"
+#include "FrozenAutomaton.h"
+#include "Inclusion.h"
+#include "Matcher.h"
+#include "Traversal.h"
 
 namespace fa {
 
@@ -19,10 +26,6 @@ namespace fa {
   
   public:
     std::vector<char> alphabet;
-    //first int is the name of the state, second corresponds to : 1->initial,2->final,3->both,0->neither
-    std::map<int,int> etats;
-    //ints are respectively names of the starting et finishing states. char is the letter.
-    std::map<int,std::multimap<char,int>> transis;
     
     /**
      * Build an empty automaton (no state, no transition).
@@ -107,6 +110,11 @@ namespace fa {
      */
     bool isStateFinal(int state) const;
 
+    /**
+     * Count the number of initial states
+     */
+    std::size_t countInitialStates() const;
+
     /**
      * Add a transition
      *
@@ -187,12 +195,37 @@ namespace fa {
      */
     bool match(const std::string& word) const;
 
+    /**
+     * Matcher of the automaton, built by the first call and kept (with its DFA
+     * cache) until a member function changes the automaton
+     */
+    const Matcher& matcher() const;
+
     /**
      * Tell if the langage accepted by the automaton is included in the
      * language accepted by the other automaton
      */
     bool isIncludedIn(const Automaton& other) const;
 
+    /**
+     * Tell if the langage accepted by the automaton is included in the
+     * language accepted by the other automaton, with the chosen algorithm
+     */
+    bool isIncludedIn(const Automaton& other,InclusionEngine engine) const;
+
+    /**
+     * Tell if the automaton and the other one accept the same language
+     * (HKC algorithm, without determinization)
+     */
+    bool isEquivalentTo(const Automaton& other) const;
+
+    /**
+     * Tell if the langage accepted by the automaton is not included in the
+     * language accepted by the other automaton. In this case, word gets a
+     * shortest word accepted by the automaton and not by the other one
+     */
+    bool findCounterexample(const Automaton& other,std::string& word) const;
+
     /**
      * Create a mirror automaton
      */
@@ -225,24 +258,114 @@ namespace fa {
      */
     static Automaton createMinimalMoore(const Automaton& other);
 
+    /**
+     * Create an equivalent minimal automaton with the Hopcroft algorithm
+     */
+    static Automaton createMinimalHopcroft(const Automaton& other);
+
     /**
      * Create an equivalent minimal automaton with the Brzozowski algorithm
      */
     static Automaton createMinimalBrzozowski(const Automaton& other);
 
+    /**
+     * Create the quotient by the coarsest forward bisimulation (same language)
+     */
+    static Automaton createBisimulationQuotient(const Automaton& other);
+
+    /**
+     * Create an equivalent automaton pruned with the forward simulation
+     */
+    static Automaton createSimulationPruned(const Automaton& other);
+
+    /**
+     * Build the read-only flat representation of the automaton (shares the
+     * cached one if there is one)
+     */
+    FrozenAutomaton freeze() const;
+
+    /**
+     * Build the table-driven minimal DFA of the automaton, to run on raw bytes
+     */
+    CompiledDfa compile() const;
+
+    /**
+     * Write the automaton in the binary format of saveAutomaton()
+     */
+    bool save(const std::string& path) const;
+
+    /**
+     * Read an automaton written by save(). Returns false if the file is not valid.
+     * The queries run on the mapped file until the automaton changes; use
+     * loadAutomaton to read it without building the maps
+     */
+    static bool load(const std::string& path,Automaton& automaton);
+
   private:
-    static std::set<int> statesFromState(const Automaton *automaton,int from);
-    static void depthSearchAccessibles(const Automaton *automaton,std::set<int> &accessibleStates,int state);
-    static std::set<int> statesToState(const Automaton *automaton,int from);
-    static void depthSearchCoAccessibles(const Automaton *automaton,std::set<int> &accessibleStates,int state);
+    //the states and transitions change only through addState, removeState,
+    //addTransition and removeTransition, which keep the indices, the reverse
+    //index and the caches up to date
+
+    //first int is the name of the state, second is its index in the initials and finals bitsets
+    std::map<int,int> etats;
+    //initial and final flags, indexed by the index stored in etats
+    Bitset initials;
+    Bitset finals;
+    //ints are respectively names of the starting et finishing states. char is the letter.
+    std::map<int,std::multimap<char,int>> transis;
+
     /**
-     * Browse the automaton to check if the language is empty (and remove the Non-Co-accessible states)
+     * Build a mutable automaton back from a frozen one
      */
-    bool DepthSearchEmpty(std::_Rb_tree_iterator<std::pair<const int, int>>& s,std::set<int>& visit);
+    static Automaton thaw(const FrozenAutomaton& frozen);
+
     /**
-     * Browse the automaton to remove the Non-accessbile states
+     * Predecessors of a state, from the reverse index (built on the first call
+     * after a change of the transitions)
      */
-    void DepthSearchRemove(std::_Rb_tree_iterator<std::pair<const int, int>>& s,std::set<int>& visit);
+    static const std::set<int>& statesToState(const Automaton *automaton,int to);
+
+    /**
+     * Run the traversal (over the indices of etats) along the transitions, or
+     * backward. Returns the first state found in targets, -1 if there is none
+     * or targets is null.
+     */
+    int search(Traversal& traversal,bool backward,const Bitset *targets) const;
+
+    /**
+     * Remove the states whose index is not in keep, with their transitions
+     */
+    void removeStatesOutside(const Bitset& keep);
+
+    //indices of the removed states, given again by addState (removeStatesOutside
+    //numbers the states 0..n-1 again and empties it)
+    std::vector<int> freeIndices;
+
+    //name of the state at each index of etats, kept up to date with it (the
+    //entries of the free indices are stale, search never reaches them)
+    std::vector<int> indexNames;
+
+    //reverse of transis (names of the predecessors of each state), valid only if reverseValid.
+    //The member functions changing the transitions update or invalidate it
+    mutable std::map<int,std::set<int>> reverseTransis;
+    mutable bool reverseValid=false;
+
+    /**
+     * Frozen automaton, built by the first call and kept until the automaton
+     * changes. readString and the matcher run on it
+     */
+    const FrozenAutomaton& frozen() const;
+
+    /**
+     * Drop the frozen automaton and the matcher, called by the member
+     * functions changing the automaton
+     */
+    void changed();
+
+    //results of frozen() and matcher(), null until they are built. Copies share
+    //them until one of them changes
+    mutable std::shared_ptr<const FrozenAutomaton> cachedFrozen;
+    mutable std::shared_ptr<Matcher> cachedMatcher;
   };
 
 }
@@ -14,7 +14,13 @@
 #include <set>
 #include <iterator>
 #include <iostream>
+#include <memory>
 #include <stdbool.h>
+#include "CompiledDfa.h"
+#include "FrozenAutomaton.h"
+#include "Inclusion.h"
+#include "Matcher.h"
+#include "Traversal.h"
 namespace fa {
   
   constexpr char Epsilon = '\0';
@@ -267,12 +273,43 @@ public:
      */
     bool match(const std::string& word) const;
 
+    /**
+     * Matcher of the automaton, built by the first call and kept (with its DFA
+     * cache) until a member function changes the automaton
+     */
+    const Matcher& matcher() const;
+
     /**
      * Tell if the langage accepted by the automaton is included in the
      * language accepted by the other automaton
      */
     bool isIncludedIn(const Automaton& other) const;
 
+    /**
+     * Tell if the langage accepted by the automaton is included in the
+     * language accepted by the other automaton, with the chosen algorithm
+     */
+    bool isIncludedIn(const Automaton& other,InclusionEngine engine) const;
+
+    /**
+     * Same, the complement engine complements the minimal DFA of the other
+     * automaton built with the chosen algorithm
+     */
+    bool isIncludedIn(const Automaton& other,InclusionEngine engine,Minimization minimization) const;
+
+    /**
+     * Tell if the langage accepted by the automaton is not included in the
+     * language accepted by the other automaton. In this case, word gets a
+     * shortest word accepted by the automaton and not by the other one
+     */
+    bool findCounterexample(const Automaton& other,std::string& word) const;
+
+    /**
+     * Tell if the automaton and the other one accept the same language
+     * (HKC algorithm, without determinization)
+     */
+    bool isEquivalentTo(const Automaton& other) const;
+
     /**
      * Create a mirror automaton
      */
@@ -305,25 +342,84 @@ public:
      */
     static Automaton createMinimalMoore(const Automaton& other);
 
+    /**
+     * Create an equivalent minimal automaton with the Hopcroft algorithm
+     */
+    static Automaton createMinimalHopcroft(const Automaton& other);
+
     /**
      * Create an equivalent minimal automaton with the Brzozowski algorithm
      */
     static Automaton createMinimalBrzozowski(const Automaton& other);
 
+    /**
+     * Create the quotient by the coarsest forward bisimulation (same language)
+     */
+    static Automaton createBisimulationQuotient(const Automaton& other);
+
+    /**
+     * Create an equivalent automaton pruned with the forward simulation
+     */
+    static Automaton createSimulationPruned(const Automaton& other);
+
+    /**
+     * Build the read-only flat representation of the automaton
+     */
+    FrozenAutomaton freeze() const;
+
+    /**
+     * Build the table-driven minimal DFA of the automaton, to run on raw bytes
+     */
+    CompiledDfa compile() const;
+
+    /**
+     * Write the automaton in the binary format of saveAutomaton()
+     */
+    bool save(const std::string& path) const;
+
+    /**
+     * Read an automaton written by save(). Returns false if the file is not valid
+     */
+    static bool load(const std::string& path,Automaton& automaton);
+
 
   private:
     /**
-     * Browse the automaton to check if the language is empty (and remove the Non-Co-accessible states)
+     * Build a mutable automaton back from a frozen one
+     */
+    static Automaton thaw(const FrozenAutomaton& frozen);
+
+    /**
+     * Run the traversal (over the ranks of the states in states) along the
+     * transitions, or backward. Returns the first state found in targets, -1 if
+     * there is none or targets is null.
      */
-    bool DepthSearchEmpty(std::_Rb_tree_const_iterator<fa::Automaton::State>& s,std::set<int>& visit)const;
+    int search(Traversal& traversal,bool backward,const Bitset *targets) const;
     /**
-     * Browse the automaton to remove the Non-accessbile states
+     * Remove the states whose rank is not in keep, with their transitions
      */
-    void DepthSearchRemove(std::_Rb_tree_const_iterator<fa::Automaton::State>& s,std::set<int>& visit);
+    void removeStatesOutside(const Bitset& keep);
     /**
      * Browse the automaton to read a word
      */
     void SearchWord(std::_Rb_tree_const_iterator<fa::Automaton::State> s,std::string& mot,const std::string& word,std::set<int>& way,int i)const;
+
+    /**
+     * Frozen automaton, built by the first call and kept until the automaton
+     * changes. readString and the matcher run on it
+     */
+    const FrozenAutomaton& frozen() const;
+
+    /**
+     * Drop the frozen automaton and the matcher, called by the member
+     * functions changing the automaton
+     */
+    void changed();
+
+    //results of frozen() and matcher(), null until they are built. Copies share
+    //them until one of them changes
+    mutable std::shared_ptr<const FrozenAutomaton> cachedFrozen;
+    mutable std::shared_ptr<Matcher> cachedMatcher;
   };
 
 }
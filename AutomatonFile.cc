@@ -0,0 +1,150 @@
+#include "AutomatonFile.h"
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fa {
+
+  /*
+  First multiple of 8 from position
+  */
+  static std::uint64_t aligned(std::uint64_t position){
+    return (position+7)&~std::uint64_t(7);
+  }
+
+  /*
+  Write size bytes at position, after zeros from the current position
+  */
+  static bool writeAt(std::FILE *file,std::uint64_t& current,std::uint64_t position,const void *data,std::size_t size){
+    static const char zeros[8]={0};
+    if(std::fwrite(zeros,1,position-current,file)!=position-current || (size!=0 && std::fwrite(data,1,size,file)!=size)){
+      return false;
+    }
+    current=position+size;
+    return true;
+  }
+
+  bool saveAutomaton(const FrozenAutomaton& automaton,const std::string& path){
+    const std::size_t n=automaton.countStates();
+    std::vector<unsigned char> flags(n);
+    for(std::size_t s=0;s<n;++s){
+      flags[s]=(automaton.isInitial(s) ? FrozenAutomaton::Initial : 0) | (automaton.isFinal(s) ? FrozenAutomaton::Final : 0);
+    }
+    const FlatArray<int>& names=automaton.stateNames();
+    const FlatArray<std::uint32_t>& offsets=automaton.transitionOffsets();
+    const FlatArray<int>& targets=automaton.transitionTargets();
+    AutomatonFileHeader header;
+    std::memset(&header,0,sizeof(header));
+    std::memcpy(header.magic,AutomatonFileHeader::Magic,sizeof(header.magic));
+    header.version=AutomatonFileHeader::Version;
+    header.byteOrder=AutomatonFileHeader::ByteOrder;
+    header.countSymbols=automaton.countSymbols();
+    header.countStates=n;
+    header.countTransitions=targets.size();
+    header.namesPosition=aligned(sizeof(header)+automaton.countSymbols());
+    header.offsetsPosition=aligned(header.namesPosition+names.size()*sizeof(int));
+    header.targetsPosition=aligned(header.offsetsPosition+offsets.size()*sizeof(std::uint32_t));
+    header.flagsPosition=aligned(header.targetsPosition+targets.size()*sizeof(int));
+    std::FILE *file=std::fopen(path.c_str(),"wb");
+    if(file==nullptr){
+      return false;
+    }
+    std::uint64_t current=0;
+    bool written=writeAt(file,current,0,&header,sizeof(header))
+      && writeAt(file,current,current,automaton.alphabet().data(),automaton.countSymbols())
+      && writeAt(file,current,header.namesPosition,names.data(),names.size()*sizeof(int))
+      && writeAt(file,current,header.offsetsPosition,offsets.data(),offsets.size()*sizeof(std::uint32_t))
+      && writeAt(file,current,header.targetsPosition,targets.data(),targets.size()*sizeof(int))
+      && writeAt(file,current,header.flagsPosition,flags.data(),n);
+    if(std::fclose(file)!=0){
+      written=false;
+    }
+    return written;
+  }
+
+  /*
+  Tell if the section of count elements of size bytes fits in the file, aligned on 8
+  */
+  static bool fits(std::uint64_t position,std::uint64_t count,std::uint64_t size,std::uint64_t fileSize){
+    return position%8==0 && position<=fileSize && count<=(fileSize-position)/size;
+  }
+
+  /*
+  Tell if the sections describe an automaton: names strictly increasing, offsets
+  non-decreasing up to the number of transitions, targets in 0..n-1
+  */
+  static bool isConsistent(const int *names,std::uint64_t n,const std::uint32_t *offsets,std::uint64_t slots,const int *targets,std::uint64_t m){
+    for(std::uint64_t s=1;s<n;++s){
+      if(names[s-1]>=names[s]){
+        return false;
+      }
+    }
+    for(std::uint64_t slot=0;slot<slots;++slot){
+      if(offsets[slot]>offsets[slot+1]){
+        return false;
+      }
+    }
+    for(std::uint64_t t=0;t<m;++t){
+      if(targets[t]<0 || static_cast<std::uint64_t>(targets[t])>=n){
+        return false;
+      }
+    }
+    return offsets[0]==0 && offsets[slots]==m;
+  }
+
+  bool loadAutomaton(const std::string& path,FrozenAutomaton& automaton){
+    const int fd=open(path.c_str(),O_RDONLY);
+    if(fd<0){
+      return false;
+    }
+    struct stat status;
+    if(fstat(fd,&status)!=0 || static_cast<std::uint64_t>(status.st_size)<sizeof(AutomatonFileHeader)){
+      close(fd);
+      return false;
+    }
+    const std::size_t fileSize=status.st_size;
+    void *address=mmap(nullptr,fileSize,PROT_READ,MAP_PRIVATE,fd,0);
+    //the mapping stays valid once the file is closed
+    close(fd);
+    if(address==MAP_FAILED){
+      return false;
+    }
+    const std::shared_ptr<const void> mapping(address,[fileSize](const void *p){ munmap(const_cast<void*>(p),fileSize); });
+    const char *base=static_cast<const char*>(address);
+    AutomatonFileHeader header;
+    std::memcpy(&header,base,sizeof(header));
+    if(std::memcmp(header.magic,AutomatonFileHeader::Magic,sizeof(header.magic))!=0
+       || header.version!=AutomatonFileHeader::Version || header.byteOrder!=AutomatonFileHeader::ByteOrder
+       || header.countSymbols>256 || sizeof(header)+header.countSymbols>fileSize){
+      return false;
+    }
+    const std::uint64_t n=header.countStates;
+    const std::uint64_t slots=n*header.countSymbols;
+    if(!fits(header.namesPosition,n,sizeof(int),fileSize)
+       || !fits(header.offsetsPosition,slots+1,sizeof(std::uint32_t),fileSize)
+       || !fits(header.targetsPosition,header.countTransitions,sizeof(int),fileSize)
+       || !fits(header.flagsPosition,n,1,fileSize)){
+      return false;
+    }
+    const int *names=reinterpret_cast<const int*>(base+header.namesPosition);
+    const std::uint32_t *offsets=reinterpret_cast<const std::uint32_t*>(base+header.offsetsPosition);
+    const int *targets=reinterpret_cast<const int*>(base+header.targetsPosition);
+    //one pass over the sections, O(nk+m), before anything indexes with them
+    if(!isConsistent(names,n,offsets,slots,targets,header.countTransitions)){
+      return false;
+    }
+    const std::vector<char> symbols(base+sizeof(header),base+sizeof(header)+header.countSymbols);
+    automaton=FrozenAutomaton(symbols,
+      FlatArray<int>(names,n,mapping),
+      reinterpret_cast<const unsigned char*>(base+header.flagsPosition),
+      FlatArray<std::uint32_t>(offsets,slots+1,mapping),
+      FlatArray<int>(targets,header.countTransitions,mapping));
+    return true;
+  }
+
+}
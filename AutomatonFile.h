@@ -0,0 +1,55 @@
+#ifndef AUTOMATON_FILE_H
+#define AUTOMATON_FILE_H
+
+#include <cstdint>
+#include <string>
+#include "FrozenAutomaton.h"
+
+namespace fa {
+
+  /**
+   * Header of the binary file of a frozen automaton.
+   *
+   * The header is followed by the symbols (one byte each), then by sections at
+   * the given file positions, each aligned on 8 bytes: the names (int32), the
+   * offsets (uint32) and the targets (int32) of the CSR table, and the flags of
+   * the states (one byte each, Initial|Final). Numbers are in the byte order of
+   * the writer, checked with byteOrder.
+   */
+  struct AutomatonFileHeader {
+    static constexpr char Magic[8]={'F','A','U','T','O','B','I','N'};
+    static constexpr std::uint32_t Version=1;
+    static constexpr std::uint32_t ByteOrder=0x01020304;
+
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+    std::uint32_t countSymbols;
+    std::uint32_t countStates;
+    std::uint64_t countTransitions;
+    std::uint64_t namesPosition;
+    std::uint64_t offsetsPosition;
+    std::uint64_t targetsPosition;
+    std::uint64_t flagsPosition;
+  };
+
+  /**
+   * Write the automaton in the binary format.
+   * Returns false if the file could not be written.
+   */
+  bool saveAutomaton(const FrozenAutomaton& automaton,const std::string& path);
+
+  /**
+   * Map the file in memory and build the automaton on it, without copying the
+   * names nor the transitions (only the alphabet and the two state bitsets are
+   * built). The mapping lives as long as the automaton or one of its copies.
+   * Returns false, leaving automaton unchanged, if the file cannot be mapped,
+   * its header or sizes are wrong, or the sections do not describe an automaton
+   * (names not strictly increasing, offsets decreasing or not ending at the
+   * number of transitions, a target out of the states), checked in O(nk+m).
+   */
+  bool loadAutomaton(const std::string& path,FrozenAutomaton& automaton);
+
+}
+
+#endif // AUTOMATON_FILE_H
@@ -0,0 +1,197 @@
+#ifndef BITSET_H
+#define BITSET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace fa {
+
+  namespace detail {
+
+    inline void orWordsScalar(std::uint64_t *dst,const std::uint64_t *src,std::size_t n){
+      for(std::size_t i=0;i<n;++i){
+        dst[i]|=src[i];
+      }
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    __attribute__((target("avx2")))
+    inline void orWordsAvx2(std::uint64_t *dst,const std::uint64_t *src,std::size_t n){
+      std::size_t i=0;
+      for(;i+4<=n;i+=4){
+        __m256i d=_mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst+i));
+        __m256i s=_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src+i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst+i),_mm256_or_si256(d,s));
+      }
+      orWordsScalar(dst+i,src+i,n-i);
+    }
+
+    __attribute__((target("sse2")))
+    inline void orWordsSse2(std::uint64_t *dst,const std::uint64_t *src,std::size_t n){
+      std::size_t i=0;
+      for(;i+2<=n;i+=2){
+        __m128i d=_mm_loadu_si128(reinterpret_cast<const __m128i*>(dst+i));
+        __m128i s=_mm_loadu_si128(reinterpret_cast<const __m128i*>(src+i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst+i),_mm_or_si128(d,s));
+      }
+      orWordsScalar(dst+i,src+i,n-i);
+    }
+#endif
+
+    /**
+     * dst|=src on n words, with the widest vector instructions of the running CPU
+     */
+    inline void orWords(std::uint64_t *dst,const std::uint64_t *src,std::size_t n){
+#if defined(__x86_64__) || defined(__i386__)
+      //short sets are not worth the dispatch
+      if(n>=8){
+        static const bool avx2=__builtin_cpu_supports("avx2");
+        if(avx2){
+          orWordsAvx2(dst,src,n);
+        }else{
+          orWordsSse2(dst,src,n);
+        }
+        return;
+      }
+#endif
+      orWordsScalar(dst,src,n);
+    }
+
+  }
+
+  /**
+   * Dynamic set of small integers (dense state indices), stored as 64-bit words.
+   *
+   * Set operations work a whole word at a time.
+   */
+  class Bitset {
+  public:
+    typedef std::uint64_t Word;
+    static constexpr std::size_t WordBits=64;
+
+    Bitset() : nbits(0) {}
+    explicit Bitset(std::size_t size) : nbits(size), words((size+WordBits-1)/WordBits,0) {}
+
+    std::size_t size() const { return nbits; }
+    std::size_t countWords() const { return words.size(); }
+    const Word *data() const { return words.data(); }
+    Word *data() { return words.data(); }
+
+    /**
+     * Change the number of bits, the new ones are cleared
+     */
+    void resize(std::size_t size){
+      nbits=size;
+      words.resize((size+WordBits-1)/WordBits,0);
+      if(nbits%WordBits!=0){
+        words.back()&=(Word(1)<<(nbits%WordBits))-1;
+      }
+    }
+
+    bool test(std::size_t i) const { return (words[i/WordBits]>>(i%WordBits))&1; }
+    void set(std::size_t i) { words[i/WordBits]|=Word(1)<<(i%WordBits); }
+    void reset(std::size_t i) { words[i/WordBits]&=~(Word(1)<<(i%WordBits)); }
+
+    void clear(){
+      for(Word &w : words){
+        w=0;
+      }
+    }
+
+    /**
+     * Number of bits set
+     */
+    std::size_t count() const{
+      std::size_t res=0;
+      for(Word w : words){
+        res+=__builtin_popcountll(w);
+      }
+      return res;
+    }
+
+    bool any() const{
+      for(Word w : words){
+        if(w!=0){
+          return true;
+        }
+      }
+      return false;
+    }
+
+    bool none() const { return !any(); }
+
+    /**
+     * Tell if the two sets share an element
+     */
+    bool intersects(const Bitset& other) const{
+      const std::size_t n=words.size()<other.words.size() ? words.size() : other.words.size();
+      for(std::size_t i=0;i<n;++i){
+        if((words[i]&other.words[i])!=0){
+          return true;
+        }
+      }
+      return false;
+    }
+
+    /**
+     * Tell if every element of the set is in other
+     */
+    bool isSubsetOf(const Bitset& other) const{
+      for(std::size_t i=0;i<words.size();++i){
+        if((words[i]&~other.words[i])!=0){
+          return false;
+        }
+      }
+      return true;
+    }
+
+    /**
+     * Add the elements of a set given as countWords() words
+     */
+    void orWith(const Word *other) { detail::orWords(words.data(),other,words.size()); }
+    void orWith(const Bitset& other) { orWith(other.data()); }
+
+    /**
+     * Keep only the elements that are also in other
+     */
+    void andWith(const Bitset& other){
+      for(std::size_t i=0;i<words.size();++i){
+        words[i]&=other.words[i];
+      }
+    }
+
+    bool operator==(const Bitset& other) const { return nbits==other.nbits && words==other.words; }
+    bool operator!=(const Bitset& other) const { return !(*this==other); }
+
+    /**
+     * Index of the first bit set at or after from, size() if there is none
+     */
+    std::size_t next(std::size_t from) const{
+      std::size_t w=from/WordBits;
+      if(w>=words.size()){
+        return nbits;
+      }
+      Word cur=words[w]&(~Word(0)<<(from%WordBits));
+      while(cur==0){
+        if(++w==words.size()){
+          return nbits;
+        }
+        cur=words[w];
+      }
+      return w*WordBits+__builtin_ctzll(cur);
+    }
+
+    std::size_t first() const { return next(0); }
+
+  private:
+    std::size_t nbits;
+    std::vector<Word> words;
+  };
+
+}
+
+#endif // BITSET_H
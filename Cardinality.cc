@@ -0,0 +1,169 @@
+#include "Cardinality.h"
+#include <algorithm>
+#include <initializer_list>
+
+namespace fa {
+
+  bool parseAmoEncoding(const std::string& name,AmoEncoding& encoding){
+    if(name=="pairwise"){
+      encoding=AmoEncoding::Pairwise;
+    }else if(name=="sequential"){
+      encoding=AmoEncoding::Sequential;
+    }else if(name=="commander"){
+      encoding=AmoEncoding::Commander;
+    }else if(name=="product"){
+      encoding=AmoEncoding::Product;
+    }else if(name=="binary"){
+      encoding=AmoEncoding::Binary;
+    }else if(name=="bimander"){
+      encoding=AmoEncoding::Bimander;
+    }else{
+      return false;
+    }
+    return true;
+  }
+
+  /*
+  Number of bits to write the integers 0..n-1
+  */
+  static int countBits(std::size_t n){
+    int bits=0;
+    while((std::size_t(1)<<bits)<n){
+      bits++;
+    }
+    return bits;
+  }
+
+  static void add(ClauseSink *sink,std::initializer_list<int> literals){
+    if(sink!=nullptr){
+      sink->addClause(literals);
+    }
+  }
+
+  /*
+  Clauses of the encoding, the auxiliary variables are taken from next.
+  Without a sink, only the variables are counted.
+  */
+  static void atMostOne(ClauseSink *sink,const std::vector<int>& x,AmoEncoding encoding,int& next){
+    const std::size_t n=x.size();
+    if(n<=1){
+      return;
+    }
+    if(n<5 || encoding==AmoEncoding::Pairwise){
+      for(std::size_t i=0;i+1<n;++i){
+        for(std::size_t j=i+1;j<n;++j){
+          add(sink,{-x[i],-x[j]});
+        }
+      }
+      return;
+    }
+    switch(encoding){
+    case AmoEncoding::Sequential:{
+      //s[i] : one of x[0..i] is true
+      const int s=next;
+      next+=n-1;
+      add(sink,{-x[0],s});
+      for(std::size_t i=1;i+1<n;++i){
+        add(sink,{-x[i],s+static_cast<int>(i)});
+        add(sink,{-(s+static_cast<int>(i)-1),s+static_cast<int>(i)});
+        add(sink,{-x[i],-(s+static_cast<int>(i)-1)});
+      }
+      add(sink,{-x[n-1],-(s+static_cast<int>(n)-2)});
+      break;
+    }
+    case AmoEncoding::Commander:{
+      std::vector<int> commanders;
+      for(std::size_t first=0;first<n;first+=3){
+        const std::size_t last=std::min(first+3,n);
+        const int c=next++;
+        commanders.push_back(c);
+        std::vector<int> group(x.begin()+first,x.begin()+last);
+        atMostOne(sink,group,AmoEncoding::Pairwise,next);
+        //the commander is true iff a literal of its group is
+        std::vector<int> clause(1,-c);
+        for(int l : group){
+          add(sink,{-l,c});
+          clause.push_back(l);
+        }
+        if(sink!=nullptr){
+          sink->addClause(clause);
+        }
+      }
+      atMostOne(sink,commanders,AmoEncoding::Commander,next);
+      break;
+    }
+    case AmoEncoding::Product:{
+      std::size_t p=1;
+      while(p*p<n){
+        p++;
+      }
+      const std::size_t q=(n+p-1)/p;
+      std::vector<int> columns(p);
+      std::vector<int> rows(q);
+      for(std::size_t i=0;i<p;++i){
+        columns[i]=next++;
+      }
+      for(std::size_t i=0;i<q;++i){
+        rows[i]=next++;
+      }
+      for(std::size_t i=0;i<n;++i){
+        add(sink,{-x[i],columns[i%p]});
+        add(sink,{-x[i],rows[i/p]});
+      }
+      atMostOne(sink,columns,AmoEncoding::Product,next);
+      atMostOne(sink,rows,AmoEncoding::Product,next);
+      break;
+    }
+    case AmoEncoding::Binary:{
+      const int bits=countBits(n);
+      const int b=next;
+      next+=bits;
+      for(std::size_t i=0;i<n;++i){
+        for(int j=0;j<bits;++j){
+          add(sink,{-x[i],(i>>j)&1 ? b+j : -(b+j)});
+        }
+      }
+      break;
+    }
+    case AmoEncoding::Bimander:{
+      const std::size_t groups=(n+1)/2;
+      const int bits=countBits(groups);
+      const int b=next;
+      next+=bits;
+      for(std::size_t g=0;g<groups;++g){
+        if(2*g+1<n){
+          add(sink,{-x[2*g],-x[2*g+1]});
+        }
+        for(std::size_t i=2*g;i<std::min(2*g+2,n);++i){
+          for(int j=0;j<bits;++j){
+            add(sink,{-x[i],(g>>j)&1 ? b+j : -(b+j)});
+          }
+        }
+      }
+      break;
+    }
+    default:
+      break;
+    }
+  }
+
+  int countAmoVariables(std::size_t n,AmoEncoding encoding){
+    std::vector<int> literals(n);
+    for(std::size_t i=0;i<n;++i){
+      literals[i]=i+1;
+    }
+    int next=n+1;
+    atMostOne(nullptr,literals,encoding,next);
+    return next-static_cast<int>(n)-1;
+  }
+
+  void addAtMostOne(ClauseSink& sink,const std::vector<int>& literals,AmoEncoding encoding,int firstVariable){
+    atMostOne(&sink,literals,encoding,firstVariable);
+  }
+
+  void addExactlyOne(ClauseSink& sink,const std::vector<int>& literals,AmoEncoding encoding,int firstVariable){
+    sink.addClause(literals);
+    addAtMostOne(sink,literals,encoding,firstVariable);
+  }
+
+}
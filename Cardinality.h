@@ -0,0 +1,53 @@
+#ifndef CARDINALITY_H
+#define CARDINALITY_H
+
+#include <string>
+#include <vector>
+#include "ClauseSink.h"
+
+namespace fa {
+
+  /**
+   * Clauses used to say that at most one literal of a set is true
+   */
+  enum class AmoEncoding {
+    //every pair of literals excluded, no auxiliary variable, n(n-1)/2 clauses
+    Pairwise,
+    //sequential counter (Sinz): n-1 auxiliary variables, 3n-4 clauses
+    Sequential,
+    //groups of 3 literals under a commander variable, then at most one commander, recursively
+    Commander,
+    //literals on a grid of about sqrt(n)*sqrt(n), at most one row and one column (Chen)
+    Product,
+    //each literal forces the bits of its index on log2(n) auxiliary variables
+    Binary,
+    //pairs of literals, pairwise inside a pair, binary encoding of the pair index
+    Bimander
+  };
+
+  /**
+   * Encoding named "pairwise", "sequential", "commander", "product", "binary" or
+   * "bimander". Returns false if the name is unknown.
+   */
+  bool parseAmoEncoding(const std::string& name,AmoEncoding& encoding);
+
+  /**
+   * Number of auxiliary variables used by addAtMostOne for n literals
+   */
+  int countAmoVariables(std::size_t n,AmoEncoding encoding);
+
+  /**
+   * Add the clauses of "at most one of literals is true". The auxiliary variables
+   * are firstVariable, firstVariable+1... countAmoVariables of them.
+   * Below 5 literals, every encoding is pairwise.
+   */
+  void addAtMostOne(ClauseSink& sink,const std::vector<int>& literals,AmoEncoding encoding,int firstVariable);
+
+  /**
+   * At least one literal (a single clause) and at most one, as addAtMostOne
+   */
+  void addExactlyOne(ClauseSink& sink,const std::vector<int>& literals,AmoEncoding encoding,int firstVariable);
+
+}
+
+#endif // CARDINALITY_H
@@ -0,0 +1,58 @@
+#ifndef CLAUSE_SINK_H
+#define CLAUSE_SINK_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <vector>
+
+namespace fa {
+
+  /**
+   * Destination of a CNF formula, fed clause by clause.
+   *
+   * Variables are numbered from 1 and literals follow DIMACS: v is the variable,
+   * -v its negation.
+   */
+  class ClauseSink {
+  public:
+    virtual ~ClauseSink() {}
+
+    /**
+     * Make sure the variables 1..count exist
+     */
+    virtual void reserveVariables(int count)=0;
+
+    /**
+     * Add a clause, a disjunction of literals
+     */
+    virtual void addClause(const std::vector<int>& literals)=0;
+  };
+
+  /**
+   * Count the variables and the clauses of a formula, to write a DIMACS header
+   * before the clauses.
+   */
+  class ClauseCounter : public ClauseSink {
+  public:
+    ClauseCounter() : variables(0),clauses(0) {}
+
+    void reserveVariables(int count) { variables=std::max(variables,count); }
+    void addClause(const std::vector<int>& literals){
+      for(int l : literals){
+        variables=std::max(variables,std::abs(l));
+      }
+      clauses++;
+    }
+
+    int countVariables() const { return variables; }
+    std::size_t countClauses() const { return clauses; }
+
+  private:
+    int variables;
+    std::size_t clauses;
+  };
+
+}
+
+#endif // CLAUSE_SINK_H
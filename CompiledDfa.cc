@@ -0,0 +1,107 @@
+#include "CompiledDfa.h"
+#include <algorithm>
+#include <map>
+
+namespace fa {
+
+  CompiledDfa::CompiledDfa(const FrozenAutomaton& automaton){
+    //complete and minimal: one row per Nerode class, at most one rejecting sink
+    const FrozenAutomaton dfa=automaton.createMinimalHopcroft();
+    const int n=dfa.countStates();
+    int sink=-1;
+    for(int s=0;s<n && sink<0;++s){
+      bool loops=!dfa.isFinal(s);
+      for(std::size_t a=0;a<dfa.countSymbols() && loops;++a){
+        loops=*dfa.successors(s,a).begin()==s;
+      }
+      if(loops){
+        sink=s;
+      }
+    }
+    //without a sink, the dead state is added after the others
+    const int states=sink<0 ? n+1 : n;
+    const int deadState=sink<0 ? n : sink;
+    //letters with the same column share a class, the class 0 is the column of the bytes outside of the alphabet
+    std::map<std::vector<int>,int> columns;
+    columns.emplace(std::vector<int>(states,deadState),0);
+    classes.fill(0);
+    std::vector<int> column(states,deadState);
+    for(std::size_t a=0;a<dfa.countSymbols();++a){
+      for(int s=0;s<n;++s){
+        column[s]=*dfa.successors(s,a).begin();
+      }
+      const int id=columns.size();
+      classes[static_cast<unsigned char>(dfa.symbol(a))]=columns.emplace(column,id).first->second;
+    }
+    nclasses=columns.size();
+    next.resize(static_cast<std::size_t>(states)*nclasses);
+    for(const std::pair<const std::vector<int>,int>& c : columns){
+      for(int s=0;s<states;++s){
+        next[static_cast<std::size_t>(s)*nclasses+c.second]=c.first[s]*nclasses;
+      }
+    }
+    accepting.assign(states,0);
+    for(int s=0;s<n;++s){
+      accepting[s]=dfa.isFinal(s);
+    }
+    start=dfa.initialStates().front()*nclasses;
+    dead=deadState*nclasses;
+  }
+
+  std::uint32_t CompiledDfa::runFrom(std::uint32_t row,const unsigned char *p,const unsigned char *end) const{
+    const std::uint32_t *table=next.data();
+    const std::uint16_t *cls=classes.data();
+    while(end-p>=4){
+      row=table[row+cls[p[0]]];
+      row=table[row+cls[p[1]]];
+      row=table[row+cls[p[2]]];
+      row=table[row+cls[p[3]]];
+      p+=4;
+      if(row==dead){
+        return row;
+      }
+    }
+    for(;p!=end;++p){
+      row=table[row+cls[*p]];
+    }
+    return row;
+  }
+
+  std::uint32_t CompiledDfa::run(const char *data,std::size_t size) const{
+    const unsigned char *p=reinterpret_cast<const unsigned char*>(data);
+    return runFrom(start,p,p+size)/nclasses;
+  }
+
+  std::vector<std::uint32_t> CompiledDfa::runInterleaved(const std::vector<std::string_view>& streams) const{
+    std::vector<std::uint32_t> res(streams.size());
+    const std::uint32_t *table=next.data();
+    const std::uint16_t *cls=classes.data();
+    std::size_t first=0;
+    for(;first+Streams<=streams.size();first+=Streams){
+      const std::string_view *group=streams.data()+first;
+      const unsigned char *p[Streams];
+      std::uint32_t row[Streams];
+      std::size_t common=group[0].size();
+      for(std::size_t j=0;j<Streams;++j){
+        p[j]=reinterpret_cast<const unsigned char*>(group[j].data());
+        row[j]=start;
+        common=std::min(common,group[j].size());
+      }
+      //the four chains of loads are independent
+      for(std::size_t i=0;i<common;++i){
+        row[0]=table[row[0]+cls[p[0][i]]];
+        row[1]=table[row[1]+cls[p[1][i]]];
+        row[2]=table[row[2]+cls[p[2][i]]];
+        row[3]=table[row[3]+cls[p[3][i]]];
+      }
+      for(std::size_t j=0;j<Streams;++j){
+        res[first+j]=runFrom(row[j],p[j]+common,p[j]+group[j].size())/nclasses;
+      }
+    }
+    for(;first<streams.size();++first){
+      res[first]=run(streams[first].data(),streams[first].size());
+    }
+    return res;
+  }
+
+}
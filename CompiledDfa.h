@@ -0,0 +1,66 @@
+#ifndef COMPILED_DFA_H
+#define COMPILED_DFA_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "FrozenAutomaton.h"
+
+namespace fa {
+
+  /**
+   * Minimal complete DFA laid out for throughput.
+   *
+   * The bytes are first mapped to classes: two letters whose columns are equal
+   * in the DFA share a class, and the bytes outside of the alphabet share the
+   * class 0, which leads to the dead state. The transitions are a dense table
+   * next[state][class]; its entries are the offsets of the target rows
+   * (state*countClasses()), so a step is two loads and an add.
+   */
+  class CompiledDfa {
+  public:
+    //streams read together by runInterleaved
+    static constexpr std::size_t Streams=4;
+
+    explicit CompiledDfa(const FrozenAutomaton& automaton);
+
+    std::size_t countStates() const { return accepting.size(); }
+    std::size_t countClasses() const { return nclasses; }
+    int symbolClass(char symbol) const { return classes[static_cast<unsigned char>(symbol)]; }
+
+    std::uint32_t initialState() const { return start/nclasses; }
+    std::uint32_t deadState() const { return dead/nclasses; }
+    bool isAccepting(std::uint32_t state) const { return accepting[state]!=0; }
+
+    /**
+     * State reached by reading the bytes. The reading stops early in the dead
+     * state.
+     */
+    std::uint32_t run(const char *data,std::size_t size) const;
+
+    bool match(const char *data,std::size_t size) const { return isAccepting(run(data,size)); }
+
+    /**
+     * State reached by every stream. The streams are read Streams at a time,
+     * one byte of each in turn, so that the loads of one stream overlap the
+     * loads of the others.
+     */
+    std::vector<std::uint32_t> runInterleaved(const std::vector<std::string_view>& streams) const;
+
+  private:
+    std::array<std::uint16_t,256> classes;
+    std::size_t nclasses;
+    std::vector<std::uint32_t> next;
+    std::vector<unsigned char> accepting;
+    //row offsets of the initial and dead states
+    std::uint32_t start;
+    std::uint32_t dead;
+
+    std::uint32_t runFrom(std::uint32_t row,const unsigned char *p,const unsigned char *end) const;
+  };
+
+}
+
+#endif // COMPILED_DFA_H
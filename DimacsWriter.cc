@@ -0,0 +1,165 @@
+#include "DimacsWriter.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace fa {
+
+  DimacsWriter::DimacsWriter(const std::string& path)
+  : file(nullptr),piped(false),patchHeader(true),headerWritten(false),failed(false),variables(0),clauses(0),announcedVariables(0),announcedClauses(0),buffer(BufferSize),used(0),written(0),headerPosition(0){
+    open(path);
+    //a pipe cannot be rewound to patch the header
+    if(piped){
+      failed=true;
+    }
+  }
+
+  DimacsWriter::DimacsWriter(const std::string& path,int variables,std::size_t clauses)
+  : file(nullptr),piped(false),patchHeader(false),headerWritten(false),failed(false),variables(0),clauses(0),announcedVariables(variables),announcedClauses(clauses),buffer(BufferSize),used(0),written(0),headerPosition(0){
+    open(path);
+  }
+
+  DimacsWriter::~DimacsWriter(){
+    close();
+  }
+
+  bool DimacsWriter::isCompressed(const std::string& path){
+    const std::size_t dot=path.rfind('.');
+    if(dot==std::string::npos){
+      return false;
+    }
+    const std::string extension=path.substr(dot);
+    return extension==".gz" || extension==".zst";
+  }
+
+  void DimacsWriter::open(const std::string& path){
+    if(isCompressed(path)){
+      const std::string program=path.substr(path.rfind('.'))==".gz" ? "gzip -c" : "zstd -q -c";
+      //the path is single-quoted for the shell, a quote in it closes, escapes and reopens the quoting
+      std::string quoted="'";
+      for(char c : path){
+        if(c=='\''){
+          quoted+="'\\''";
+        }else{
+          quoted+=c;
+        }
+      }
+      quoted+='\'';
+      const std::string command=program+" > "+quoted;
+      file=popen(command.c_str(),"w");
+      piped=true;
+    }else{
+      file=std::fopen(path.c_str(),"wb");
+    }
+    if(file==nullptr){
+      failed=true;
+    }
+  }
+
+  void DimacsWriter::reserveVariables(int count){
+    if(count>variables){
+      variables=count;
+    }
+  }
+
+  void DimacsWriter::writeHeader(){
+    if(used+HeaderSize>BufferSize){
+      flush();
+    }
+    if(patchHeader){
+      headerPosition=written+used;
+      for(std::size_t i=0;i+1<HeaderSize;++i){
+        buffer[used++]=' ';
+      }
+      buffer[used++]='\n';
+    }else{
+      used+=std::snprintf(buffer.data()+used,BufferSize-used,"p cnf %d %zu\n",announcedVariables,announcedClauses);
+    }
+    headerWritten=true;
+  }
+
+  void DimacsWriter::writeInt(int value){
+    //the widest int and a separator always fit
+    if(used+12>BufferSize){
+      flush();
+    }
+    char digits[12];
+    int n=0;
+    unsigned int magnitude=value<0 ? 0u-static_cast<unsigned int>(value) : value;
+    do{
+      digits[n++]='0'+magnitude%10;
+      magnitude/=10;
+    }while(magnitude!=0);
+    if(value<0){
+      buffer[used++]='-';
+    }
+    while(n>0){
+      buffer[used++]=digits[--n];
+    }
+  }
+
+  void DimacsWriter::addClause(const std::vector<int>& literals){
+    if(!headerWritten){
+      writeHeader();
+    }
+    for(int l : literals){
+      writeInt(l);
+      buffer[used++]=' ';
+      reserveVariables(std::abs(l));
+    }
+    if(used+2>BufferSize){
+      flush();
+    }
+    buffer[used++]='0';
+    buffer[used++]='\n';
+    clauses++;
+  }
+
+  void DimacsWriter::addComment(const std::string& text){
+    if(used+text.size()+3>BufferSize){
+      flush();
+    }
+    if(text.size()+3>BufferSize){
+      failed=true;
+      return;
+    }
+    buffer[used++]='c';
+    buffer[used++]=' ';
+    used=std::copy(text.begin(),text.end(),buffer.begin()+used)-buffer.begin();
+    buffer[used++]='\n';
+  }
+
+  void DimacsWriter::flush(){
+    if(file!=nullptr && used>0 && std::fwrite(buffer.data(),1,used,file)!=used){
+      failed=true;
+    }
+    written+=used;
+    used=0;
+  }
+
+  bool DimacsWriter::close(){
+    if(file==nullptr){
+      return false;
+    }
+    if(!headerWritten){
+      writeHeader();
+    }
+    flush();
+    if(patchHeader && !piped){
+      char header[HeaderSize+1];
+      const int n=std::snprintf(header,sizeof(header),"p cnf %d %zu",variables,clauses);
+      if(n<0 || static_cast<std::size_t>(n)>=HeaderSize || std::fseek(file,headerPosition,SEEK_SET)!=0 || std::fwrite(header,1,n,file)!=static_cast<std::size_t>(n)){
+        failed=true;
+      }
+    }
+    if(!patchHeader && (variables>announcedVariables || clauses!=announcedClauses)){
+      failed=true;
+    }
+    const int status=piped ? pclose(file) : std::fclose(file);
+    if(status!=0){
+      failed=true;
+    }
+    file=nullptr;
+    return !failed;
+  }
+
+}
@@ -0,0 +1,85 @@
+#ifndef DIMACS_WRITER_H
+#define DIMACS_WRITER_H
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "ClauseSink.h"
+
+namespace fa {
+
+  /**
+   * Write a formula in DIMACS CNF, through a large buffer.
+   *
+   * A path ending in ".gz" or ".zst" is compressed by piping the text into gzip
+   * or zstd. The header "p cnf V C" must then be known before the first clause
+   * (count the formula with a ClauseCounter first). For a plain file the header
+   * can be left to the writer: it is reserved with padding, then patched with
+   * the counts by close(). The header is written with the first clause, after
+   * the comments added before it.
+   */
+  class DimacsWriter : public ClauseSink {
+  public:
+    /**
+     * Plain file, the header is patched by close()
+     */
+    explicit DimacsWriter(const std::string& path);
+
+    /**
+     * Plain or compressed file, with the header written first
+     */
+    DimacsWriter(const std::string& path,int variables,std::size_t clauses);
+
+    ~DimacsWriter();
+
+    void reserveVariables(int count);
+    void addClause(const std::vector<int>& literals);
+
+    /**
+     * Write the line "c text", text must not contain a newline. Before the
+     * first clause, the line goes before the header
+     */
+    void addComment(const std::string& text);
+
+    /**
+     * Flush the buffer and finish the file. Returns false if something could not
+     * be written, or if the clauses do not match the announced header.
+     */
+    bool close();
+
+    int countVariables() const { return variables; }
+    std::size_t countClauses() const { return clauses; }
+
+    static bool isCompressed(const std::string& path);
+
+  private:
+    static const std::size_t BufferSize=1<<20;
+    //reserved length of a patched header
+    static const std::size_t HeaderSize=40;
+
+    void open(const std::string& path);
+    void writeHeader();
+    void writeInt(int value);
+    void flush();
+
+    std::FILE *file;
+    bool piped;
+    bool patchHeader;
+    bool headerWritten;
+    bool failed;
+    int variables;
+    std::size_t clauses;
+    int announcedVariables;
+    std::size_t announcedClauses;
+    std::vector<char> buffer;
+    std::size_t used;
+    //bytes flushed to the file
+    std::size_t written;
+    //file position of a patched header
+    std::size_t headerPosition;
+  };
+
+}
+
+#endif // DIMACS_WRITER_H
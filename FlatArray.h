@@ -0,0 +1,53 @@
+#ifndef FLAT_ARRAY_H
+#define FLAT_ARRAY_H
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace fa {
+
+  /**
+   * Read-only array, either owned or a view into memory kept alive by an owner
+   * (a mapped file for instance).
+   *
+   * Copies share the elements, which is safe since they are never modified.
+   */
+  template<class T>
+  class FlatArray {
+  public:
+    FlatArray() : first(nullptr),count(0) {}
+
+    /**
+     * Take the values
+     */
+    explicit FlatArray(std::vector<T>&& values){
+      std::shared_ptr<std::vector<T>> storage=std::make_shared<std::vector<T>>(std::move(values));
+      first=storage->data();
+      count=storage->size();
+      owner=std::move(storage);
+    }
+
+    /**
+     * View of count values at first, valid as long as owner is alive
+     */
+    FlatArray(const T *first,std::size_t count,std::shared_ptr<const void> owner)
+    : owner(std::move(owner)),first(first),count(count) {}
+
+    std::size_t size() const { return count; }
+    bool empty() const { return count==0; }
+    const T *data() const { return first; }
+    const T *begin() const { return first; }
+    const T *end() const { return first+count; }
+    const T& operator[](std::size_t i) const { return first[i]; }
+
+  private:
+    std::shared_ptr<const void> owner;
+    const T *first;
+    std::size_t count;
+  };
+
+}
+
+#endif // FLAT_ARRAY_H
@@ -0,0 +1,880 @@
+#include "FrozenAutomaton.h"
+#include <algorithm>
+#include <map>
+#include "PairTable.h"
+#include "SubsetTable.h"
+#include "SuccessorMasks.h"
+#include "Traversal.h"
+
+namespace fa {
+
+  FrozenAutomaton::FrozenAutomaton()
+  : offsets(std::vector<std::uint32_t>(1,0)){
+    std::fill(symbolIndices,symbolIndices+256,-1);
+  }
+
+  FrozenAutomaton::FrozenAutomaton(const std::vector<char>& symbols,const std::vector<int>& names,const std::vector<unsigned char>& flags,const std::vector<Edge>& edges)
+  : symbols(symbols),names(std::vector<int>(names)),initials(names.size()),finals(names.size()){
+    std::fill(symbolIndices,symbolIndices+256,-1);
+    for(std::size_t i=0;i<names.size();++i){
+      if(flags[i]&Initial){
+        initials.set(i);
+      }
+      if(flags[i]&Final){
+        finals.set(i);
+      }
+    }
+    for(std::size_t i=0;i<symbols.size();++i){
+      symbolIndices[static_cast<unsigned char>(symbols[i])]=i;
+    }
+    //counting sort of the edges by (from,symbol)
+    const std::size_t slots=names.size()*symbols.size();
+    std::vector<std::uint32_t> offsets(slots+1,0);
+    for(const Edge& e : edges){
+      ++offsets[static_cast<std::size_t>(e.from)*symbols.size()+e.symbol+1];
+    }
+    for(std::size_t i=0;i<slots;++i){
+      offsets[i+1]+=offsets[i];
+    }
+    std::vector<int> targets(edges.size());
+    std::vector<std::uint32_t> fill(offsets.begin(),offsets.end()-1);
+    for(const Edge& e : edges){
+      targets[fill[static_cast<std::size_t>(e.from)*symbols.size()+e.symbol]++]=e.to;
+    }
+    //sort each slot and remove the duplicated edges
+    std::uint32_t write=0;
+    for(std::size_t i=0;i<slots;++i){
+      int *first=targets.data()+offsets[i];
+      int *last=targets.data()+offsets[i+1];
+      std::sort(first,last);
+      last=std::unique(first,last);
+      offsets[i]=write;
+      write=std::copy(first,last,targets.begin()+write)-targets.begin();
+    }
+    offsets[slots]=write;
+    targets.resize(write);
+    this->offsets=FlatArray<std::uint32_t>(std::move(offsets));
+    this->targets=FlatArray<int>(std::move(targets));
+  }
+
+  FrozenAutomaton::FrozenAutomaton(const std::vector<char>& symbols,const FlatArray<int>& names,const unsigned char *flags,const FlatArray<std::uint32_t>& offsets,const FlatArray<int>& targets)
+  : symbols(symbols),names(names),initials(names.size()),finals(names.size()),offsets(offsets),targets(targets){
+    std::fill(symbolIndices,symbolIndices+256,-1);
+    for(std::size_t i=0;i<symbols.size();++i){
+      symbolIndices[static_cast<unsigned char>(symbols[i])]=i;
+    }
+    for(std::size_t i=0;i<names.size();++i){
+      if(flags[i]&Initial){
+        initials.set(i);
+      }
+      if(flags[i]&Final){
+        finals.set(i);
+      }
+    }
+  }
+
+  int FrozenAutomaton::stateIndex(int name) const{
+    const int *it=std::lower_bound(names.begin(),names.end(),name);
+    if(it==names.end() || *it!=name){
+      return -1;
+    }
+    return it-names.begin();
+  }
+
+  std::vector<int> FrozenAutomaton::initialStates() const{
+    std::vector<int> res;
+    for(std::size_t s=initials.first();s<names.size();s=initials.next(s+1)){
+      res.push_back(s);
+    }
+    return res;
+  }
+
+  bool FrozenAutomaton::isDeterministic() const{
+    if(countInitialStates()!=1){
+      return false;
+    }
+    for(std::size_t i=0;i+1<offsets.size();++i){
+      if(offsets[i+1]-offsets[i]>1){
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool FrozenAutomaton::isComplete() const{
+    for(std::size_t i=0;i+1<offsets.size();++i){
+      if(offsets[i+1]==offsets[i]){
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /*
+  Search from the initial states along the transitions, stopped at the first state of targets if not null
+  */
+  static int searchForward(const FrozenAutomaton& automaton,Traversal& traversal,const Bitset *targets){
+    for(int s : automaton.initialStates()){
+      traversal.addSource(s);
+    }
+    return traversal.run([&automaton](int s,const auto& add){
+      for(std::size_t a=0;a<automaton.countSymbols();++a){
+        for(int to : automaton.successors(s,a)){
+          add(to);
+        }
+      }
+    },[targets](int s){
+      return targets!=nullptr && targets->test(s);
+    });
+  }
+
+  Bitset FrozenAutomaton::accessibleStates() const{
+    Traversal traversal(countStates());
+    searchForward(*this,traversal,nullptr);
+    return traversal.visited();
+  }
+
+  bool FrozenAutomaton::isLanguageEmpty() const{
+    Traversal traversal(countStates());
+    return searchForward(*this,traversal,&finals)<0;
+  }
+
+  bool FrozenAutomaton::hasEmptyIntersectionWith(const FrozenAutomaton& other) const{
+    //symbols of this automaton as seen by other, -1 if other does not have it
+    std::vector<int> otherSymbols(symbols.size());
+    for(std::size_t a=0;a<symbols.size();++a){
+      otherSymbols[a]=other.symbolIndex(symbols[a]);
+    }
+    PairTable visit;
+    std::vector<std::uint64_t> queue;
+    for(int p : initialStates()){
+      for(int q : other.initialStates()){
+        visit.insert(p,q);
+        queue.push_back(PairTable::key(p,q));
+      }
+    }
+    for(std::size_t head=0;head<queue.size();++head){
+      const int p=PairTable::first(queue[head]);
+      const int q=PairTable::second(queue[head]);
+      if(isFinal(p) && other.isFinal(q)){
+        return false;
+      }
+      for(std::size_t a=0;a<symbols.size();++a){
+        if(otherSymbols[a]<0){
+          continue;
+        }
+        FrozenAutomaton::StateRange rhsTargets=other.successors(q,otherSymbols[a]);
+        for(int to1 : successors(p,a)){
+          for(int to2 : rhsTargets){
+            if(visit.insert(to1,to2).second){
+              queue.push_back(PairTable::key(to1,to2));
+            }
+          }
+        }
+      }
+    }
+    return true;
+  }
+
+  FrozenAutomaton FrozenAutomaton::createProduct(const FrozenAutomaton& lhs,const FrozenAutomaton& rhs){
+    std::vector<char> common;
+    //symbol indices in lhs and rhs of each common symbol
+    std::vector<int> lhsSymbols;
+    std::vector<int> rhsSymbols;
+    for(std::size_t a=0;a<lhs.countSymbols();++a){
+      if(rhs.symbolIndex(lhs.symbol(a))>=0){
+        common.push_back(lhs.symbol(a));
+        lhsSymbols.push_back(a);
+        rhsSymbols.push_back(rhs.symbolIndex(lhs.symbol(a)));
+      }
+    }
+    if(common.empty()){
+      common.push_back('#');
+    }
+    std::vector<Edge> edges;
+    const std::vector<int> init1=lhs.initialStates();
+    const std::vector<int> init2=rhs.initialStates();
+    if(init1.empty() || init2.empty()){
+      return FrozenAutomaton(common,std::vector<int>(1,0),std::vector<unsigned char>(1,0),edges);
+    }
+    //pairs in id order, the position in the vector is the id given by the index
+    PairTable index;
+    std::vector<std::uint64_t> pairs;
+    for(int q : init2){
+      for(int p : init1){
+        if(index.insert(p,q).second){
+          pairs.push_back(PairTable::key(p,q));
+        }
+      }
+    }
+    for(std::size_t n=0;n<pairs.size();++n){
+      const int p=PairTable::first(pairs[n]);
+      const int q=PairTable::second(pairs[n]);
+      for(std::size_t a=0;a<lhsSymbols.size();++a){
+        FrozenAutomaton::StateRange rhsTargets=rhs.successors(q,rhsSymbols[a]);
+        for(int to1 : lhs.successors(p,lhsSymbols[a])){
+          for(int to2 : rhsTargets){
+            std::pair<int,bool> found=index.insert(to1,to2);
+            if(found.second){
+              pairs.push_back(PairTable::key(to1,to2));
+            }
+            edges.push_back(Edge{static_cast<int>(n),static_cast<int>(a),found.first});
+          }
+        }
+      }
+    }
+    std::vector<int> names(pairs.size());
+    std::vector<unsigned char> flags(pairs.size(),0);
+    for(std::size_t n=0;n<pairs.size();++n){
+      names[n]=n;
+      if(n<init1.size()*init2.size()){
+        flags[n]|=Initial;
+      }
+      if(lhs.isFinal(PairTable::first(pairs[n])) && rhs.isFinal(PairTable::second(pairs[n]))){
+        flags[n]|=Final;
+      }
+    }
+    return FrozenAutomaton(common,names,flags,edges);
+  }
+
+  Bitset FrozenAutomaton::readString(const std::string& word) const{
+    //no setup for a single word: the masks of a Matcher pay off over many words
+    Bitset current=initials;
+    Bitset next(countStates());
+    for(char c : word){
+      const int symbol=symbolIndex(c);
+      if(symbol<0){
+        return Bitset(countStates());
+      }
+      next.clear();
+      for(std::size_t s=current.first();s<countStates();s=current.next(s+1)){
+        for(int to : successors(s,symbol)){
+          next.set(to);
+        }
+      }
+      std::swap(current,next);
+    }
+    return current;
+  }
+
+  /*
+  Subset construction with the subsets as bitsets, one step is an union of successor masks
+  */
+  static FrozenAutomaton determinizeMasks(const FrozenAutomaton& nfa){
+    const SuccessorMasks masks(nfa);
+    std::vector<FrozenAutomaton::Edge> edges;
+    std::vector<unsigned char> resFlags;
+    const std::size_t nwords=masks.countWords();
+    SubsetTable<Bitset::Word> tab;
+    Bitset curr(nfa.countStates());
+    Bitset next(nfa.countStates());
+    tab.insert(nfa.initialStateSet().data(),nfa.initialStateSet().data()+nwords);
+    resFlags.push_back(FrozenAutomaton::Initial | (nfa.hasFinalState(nfa.initialStateSet()) ? FrozenAutomaton::Final : 0));
+    for(std::size_t n=0;n<tab.size();++n){
+      std::copy(tab.begin(n),tab.end(n),curr.data());
+      for(std::size_t a=0;a<nfa.countSymbols();++a){
+        masks.step(curr,a,next);
+        if(next.none()){
+          continue;
+        }
+        std::pair<int,bool> found=tab.insert(next.data(),next.data()+nwords);
+        if(found.second){
+          resFlags.push_back(nfa.hasFinalState(next) ? FrozenAutomaton::Final : 0);
+        }
+        edges.push_back(FrozenAutomaton::Edge{static_cast<int>(n),static_cast<int>(a),found.first});
+      }
+    }
+    std::vector<int> resNames(tab.size());
+    for(std::size_t n=0;n<tab.size();++n){
+      resNames[n]=n;
+    }
+    return FrozenAutomaton(nfa.alphabet(),resNames,resFlags,edges);
+  }
+
+  FrozenAutomaton FrozenAutomaton::createDeterministic() const{
+    std::vector<int> curr=initialStates();
+    if(curr.empty()){
+      return FrozenAutomaton(symbols,std::vector<int>(1,0),std::vector<unsigned char>(1,Initial),std::vector<Edge>());
+    }
+    if(countStates()<=SuccessorMasks::MaxStates){
+      return determinizeMasks(*this);
+    }
+    //too many states for the masks: subsets are interned as sorted vectors of indices
+    SubsetTable<int> tab;
+    std::vector<Edge> edges;
+    std::vector<unsigned char> resFlags;
+    tab.insert(curr.data(),curr.data()+curr.size());
+    resFlags.push_back(Initial);
+    for(std::size_t n=0;n<tab.size();++n){
+      for(std::size_t a=0;a<symbols.size();++a){
+        curr.clear();
+        for(const int *s=tab.begin(n);s!=tab.end(n);++s){
+          for(int to : successors(*s,a)){
+            curr.push_back(to);
+          }
+        }
+        if(curr.empty()){
+          continue;
+        }
+        std::sort(curr.begin(),curr.end());
+        curr.erase(std::unique(curr.begin(),curr.end()),curr.end());
+        std::pair<int,bool> found=tab.insert(curr.data(),curr.data()+curr.size());
+        if(found.second){
+          resFlags.push_back(0);
+        }
+        edges.push_back(Edge{static_cast<int>(n),static_cast<int>(a),found.first});
+      }
+    }
+    std::vector<int> resNames(tab.size());
+    for(std::size_t n=0;n<tab.size();++n){
+      resNames[n]=n;
+      for(const int *s=tab.begin(n);s!=tab.end(n);++s){
+        if(isFinal(*s)){
+          resFlags[n]|=Final;
+          break;
+        }
+      }
+    }
+    return FrozenAutomaton(symbols,resNames,resFlags,edges);
+  }
+
+  /*
+  Automaton of the classes of block (numbered in the order of their first state),
+  with the edges and flags of their states
+  */
+  static FrozenAutomaton createQuotient(const FrozenAutomaton& automaton,const std::vector<int>& block,int count){
+    std::vector<int> resNames(count,0);
+    std::vector<unsigned char> resFlags(count,0);
+    std::vector<bool> named(count,false);
+    std::vector<FrozenAutomaton::Edge> edges;
+    for(std::size_t s=0;s<automaton.countStates();++s){
+      const int b=block[s];
+      //states are sorted by name, the first one has the smallest
+      if(!named[b]){
+        named[b]=true;
+        resNames[b]=automaton.stateName(s);
+      }
+      if(automaton.isInitial(s)){
+        resFlags[b]|=FrozenAutomaton::Initial;
+      }
+      if(automaton.isFinal(s)){
+        resFlags[b]|=FrozenAutomaton::Final;
+      }
+      for(std::size_t a=0;a<automaton.countSymbols();++a){
+        for(int to : automaton.successors(s,a)){
+          edges.push_back(FrozenAutomaton::Edge{b,static_cast<int>(a),block[to]});
+        }
+      }
+    }
+    return FrozenAutomaton(automaton.alphabet(),resNames,resFlags,edges);
+  }
+
+  /*
+  Automaton restricted to the states of keep, with the same names
+  */
+  static FrozenAutomaton createRestriction(const FrozenAutomaton& automaton,const Bitset& keep){
+    std::vector<int> index(automaton.countStates(),-1);
+    std::vector<int> names;
+    std::vector<unsigned char> flags;
+    for(std::size_t s=keep.first();s<automaton.countStates();s=keep.next(s+1)){
+      index[s]=names.size();
+      names.push_back(automaton.stateName(s));
+      flags.push_back((automaton.isInitial(s) ? FrozenAutomaton::Initial : 0) | (automaton.isFinal(s) ? FrozenAutomaton::Final : 0));
+    }
+    std::vector<FrozenAutomaton::Edge> edges;
+    for(std::size_t s=keep.first();s<automaton.countStates();s=keep.next(s+1)){
+      for(std::size_t a=0;a<automaton.countSymbols();++a){
+        for(int to : automaton.successors(s,a)){
+          if(index[to]>=0){
+            edges.push_back(FrozenAutomaton::Edge{index[s],static_cast<int>(a),index[to]});
+          }
+        }
+      }
+    }
+    return FrozenAutomaton(automaton.alphabet(),names,flags,edges);
+  }
+
+  FrozenAutomaton FrozenAutomaton::createBisimulationQuotient() const{
+    const std::size_t n=countStates();
+    //first partition: final or not, then split until the signatures are stable
+    std::vector<int> block(n);
+    int count=0;
+    if(n>0){
+      const bool firstFinal=isFinal(0);
+      for(std::size_t s=0;s<n;++s){
+        block[s]=isFinal(s)==firstFinal ? 0 : 1;
+        if(block[s]+1>count){
+          count=block[s]+1;
+        }
+      }
+    }
+    std::vector<int> signature;
+    std::vector<int> targetBlocks;
+    for(;;){
+      //signature of a state: its block, then the sorted blocks of its successors for each symbol
+      std::map<std::vector<int>,int> blocks;
+      std::vector<int> next(n);
+      for(std::size_t s=0;s<n;++s){
+        signature.assign(1,block[s]);
+        for(std::size_t a=0;a<symbols.size();++a){
+          targetBlocks.clear();
+          for(int to : successors(s,a)){
+            targetBlocks.push_back(block[to]);
+          }
+          std::sort(targetBlocks.begin(),targetBlocks.end());
+          targetBlocks.erase(std::unique(targetBlocks.begin(),targetBlocks.end()),targetBlocks.end());
+          signature.push_back(targetBlocks.size());
+          signature.insert(signature.end(),targetBlocks.begin(),targetBlocks.end());
+        }
+        next[s]=blocks.insert(std::pair<std::vector<int>,int>(signature,blocks.size())).first->second;
+      }
+      block.swap(next);
+      //a block is never merged, the partition is stable when no block was split
+      if(static_cast<int>(blocks.size())==count){
+        break;
+      }
+      count=blocks.size();
+    }
+    return createQuotient(*this,block,count);
+  }
+
+  /*
+  For each state q, the set of the states simulating q
+  */
+  static std::vector<Bitset> computeSimulation(const FrozenAutomaton& automaton){
+    const std::size_t n=automaton.countStates();
+    const std::size_t k=automaton.countSymbols();
+    //successor sets of each (state,symbol)
+    std::vector<Bitset> post(n*k,Bitset(n));
+    for(std::size_t s=0;s<n;++s){
+      for(std::size_t a=0;a<k;++a){
+        for(int to : automaton.successors(s,a)){
+          post[s*k+a].set(to);
+        }
+      }
+    }
+    std::vector<Bitset> sim(n,Bitset(n));
+    for(std::size_t q=0;q<n;++q){
+      for(std::size_t r=0;r<n;++r){
+        if(!automaton.isFinal(q) || automaton.isFinal(r)){
+          sim[q].set(r);
+        }
+      }
+    }
+    bool changed=true;
+    while(changed){
+      changed=false;
+      for(std::size_t q=0;q<n;++q){
+        for(std::size_t r=sim[q].first();r<n;r=sim[q].next(r+1)){
+          bool matched=true;
+          for(std::size_t a=0;a<k && matched;++a){
+            for(int to : automaton.successors(q,a)){
+              if(!sim[to].intersects(post[r*k+a])){
+                matched=false;
+                break;
+              }
+            }
+          }
+          if(!matched){
+            sim[q].reset(r);
+            changed=true;
+          }
+        }
+      }
+    }
+    return sim;
+  }
+
+  /*
+  Remove from states the ones strictly simulated by another one of states
+  */
+  static void keepMaximal(std::vector<int>& states,const std::vector<Bitset>& sim){
+    std::vector<int> kept;
+    for(int q : states){
+      bool dominated=false;
+      for(int r : states){
+        if(r!=q && sim[q].test(r)){
+          dominated=true;
+          break;
+        }
+      }
+      if(!dominated){
+        kept.push_back(q);
+      }
+    }
+    states.swap(kept);
+  }
+
+  FrozenAutomaton FrozenAutomaton::createSimulationPruned() const{
+    const std::vector<Bitset> sim=computeSimulation(*this);
+    //classes of the states simulating each other, a class is represented by its first state
+    std::vector<int> block(countStates(),-1);
+    std::vector<int> representatives;
+    for(std::size_t q=0;q<countStates();++q){
+      if(block[q]>=0){
+        continue;
+      }
+      block[q]=representatives.size();
+      for(std::size_t r=sim[q].next(q+1);r<countStates();r=sim[q].next(r+1)){
+        if(sim[r].test(q)){
+          block[r]=block[q];
+        }
+      }
+      representatives.push_back(q);
+    }
+    const FrozenAutomaton quotient=createQuotient(*this,block,representatives.size());
+    //simulation between classes, a partial order
+    const std::size_t n=quotient.countStates();
+    std::vector<Bitset> order(n,Bitset(n));
+    for(std::size_t c=0;c<n;++c){
+      for(std::size_t d=0;d<n;++d){
+        if(sim[representatives[c]].test(representatives[d])){
+          order[c].set(d);
+        }
+      }
+    }
+    std::vector<int> initialStates=quotient.initialStates();
+    keepMaximal(initialStates,order);
+    std::vector<Edge> edges;
+    std::vector<int> states;
+    for(std::size_t c=0;c<n;++c){
+      for(std::size_t a=0;a<quotient.countSymbols();++a){
+        FrozenAutomaton::StateRange range=quotient.successors(c,a);
+        states.assign(range.begin(),range.end());
+        keepMaximal(states,order);
+        for(int to : states){
+          edges.push_back(Edge{static_cast<int>(c),static_cast<int>(a),to});
+        }
+      }
+    }
+    std::vector<unsigned char> flags(n,0);
+    std::vector<int> names(n);
+    for(std::size_t c=0;c<n;++c){
+      names[c]=quotient.stateName(c);
+      if(quotient.isFinal(c)){
+        flags[c]|=Final;
+      }
+    }
+    for(int c : initialStates){
+      flags[c]|=Initial;
+    }
+    //dropped transitions can leave states out of reach, keep the accessible ones
+    const FrozenAutomaton pruned(symbols,names,flags,edges);
+    return createRestriction(pruned,pruned.accessibleStates());
+  }
+
+  /*
+  Accessible part of the automaton made deterministic, then complete: the missing
+  transitions go to a sink state named after the last state
+  */
+  static FrozenAutomaton createCompleteDeterministic(const FrozenAutomaton& automaton){
+    const FrozenAutomaton dfa=automaton.isDeterministic() ? createRestriction(automaton,automaton.accessibleStates()) : automaton.createDeterministic();
+    if(dfa.isComplete()){
+      return dfa;
+    }
+    const int sink=dfa.countStates();
+    std::vector<int> names(sink+1);
+    std::vector<unsigned char> flags(sink+1,0);
+    std::vector<FrozenAutomaton::Edge> edges;
+    for(int s=0;s<sink;++s){
+      names[s]=dfa.stateName(s);
+      flags[s]=(dfa.isInitial(s) ? FrozenAutomaton::Initial : 0) | (dfa.isFinal(s) ? FrozenAutomaton::Final : 0);
+      for(std::size_t a=0;a<dfa.countSymbols();++a){
+        FrozenAutomaton::StateRange range=dfa.successors(s,a);
+        edges.push_back(FrozenAutomaton::Edge{s,static_cast<int>(a),range.empty() ? sink : *range.begin()});
+      }
+    }
+    names[sink]=sink==0 ? 0 : names[sink-1]+1;
+    for(std::size_t a=0;a<dfa.countSymbols();++a){
+      edges.push_back(FrozenAutomaton::Edge{sink,static_cast<int>(a),sink});
+    }
+    return FrozenAutomaton(dfa.alphabet(),names,flags,edges);
+  }
+
+  FrozenAutomaton FrozenAutomaton::createMinimalMoore() const{
+    //on a complete accessible DFA, the coarsest bisimulation is the Nerode equivalence
+    return createCompleteDeterministic(*this).createBisimulationQuotient();
+  }
+
+  FrozenAutomaton FrozenAutomaton::createMinimalHopcroft() const{
+    const FrozenAutomaton dfa=createCompleteDeterministic(*this);
+    const int n=dfa.countStates();
+    const int k=dfa.countSymbols();
+    //predecessors of (state,symbol), in CSR form like the transitions
+    std::vector<int> inverseOffsets(static_cast<std::size_t>(n)*k+1,0);
+    std::vector<int> inverseSources(static_cast<std::size_t>(n)*k);
+    for(int s=0;s<n;++s){
+      for(int a=0;a<k;++a){
+        ++inverseOffsets[static_cast<std::size_t>(*dfa.successors(s,a).begin())*k+a+1];
+      }
+    }
+    for(std::size_t i=0;i+1<inverseOffsets.size();++i){
+      inverseOffsets[i+1]+=inverseOffsets[i];
+    }
+    std::vector<int> fill(inverseOffsets.begin(),inverseOffsets.end()-1);
+    for(int s=0;s<n;++s){
+      for(int a=0;a<k;++a){
+        inverseSources[fill[static_cast<std::size_t>(*dfa.successors(s,a).begin())*k+a]++]=s;
+      }
+    }
+    //refinable partition: the states of a block are contiguous in elements,
+    //the marked ones at the beginning of the block
+    std::vector<int> elements;
+    std::vector<int> location(n);
+    std::vector<int> block(n);
+    std::vector<int> blockFirst;
+    std::vector<int> blockEnd;
+    std::vector<int> marked;
+    for(int pass=0;pass<2;++pass){
+      const std::size_t first=elements.size();
+      for(int s=0;s<n;++s){
+        if(dfa.isFinal(s)==(pass==0)){
+          location[s]=elements.size();
+          block[s]=blockFirst.size();
+          elements.push_back(s);
+        }
+      }
+      if(elements.size()>first){
+        blockFirst.push_back(first);
+        blockEnd.push_back(elements.size());
+        marked.push_back(0);
+      }
+    }
+    //splitters (block,symbol), one flag per pair
+    std::vector<int> waiting;
+    std::vector<bool> isWaiting(blockFirst.size()*k,false);
+    if(blockFirst.size()==2){
+      const int smaller=blockEnd[0]-blockFirst[0]<=blockEnd[1]-blockFirst[1] ? 0 : 1;
+      for(int a=0;a<k;++a){
+        waiting.push_back(smaller*k+a);
+        isWaiting[smaller*k+a]=true;
+      }
+    }
+    std::vector<int> splitter;
+    std::vector<int> touched;
+    while(!waiting.empty()){
+      const int b=waiting.back()/k;
+      const int a=waiting.back()%k;
+      waiting.pop_back();
+      isWaiting[b*k+a]=false;
+      //the splitter can itself be split below, its states are copied first
+      splitter.assign(elements.begin()+blockFirst[b],elements.begin()+blockEnd[b]);
+      for(int t : splitter){
+        for(int i=inverseOffsets[static_cast<std::size_t>(t)*k+a];i<inverseOffsets[static_cast<std::size_t>(t)*k+a+1];++i){
+          //a state has one successor by a, it is marked at most once
+          const int s=inverseSources[i];
+          const int c=block[s];
+          const int target=blockFirst[c]+marked[c];
+          const int other=elements[target];
+          elements[target]=s;
+          elements[location[s]]=other;
+          location[other]=location[s];
+          location[s]=target;
+          if(marked[c]++==0){
+            touched.push_back(c);
+          }
+        }
+      }
+      for(int c : touched){
+        if(marked[c]==blockEnd[c]-blockFirst[c]){
+          marked[c]=0;
+          continue;
+        }
+        //the marked states form a new block
+        const int created=blockFirst.size();
+        blockFirst.push_back(blockFirst[c]);
+        blockEnd.push_back(blockFirst[c]+marked[c]);
+        marked.push_back(0);
+        blockFirst[c]+=marked[c];
+        marked[c]=0;
+        for(int i=blockFirst[created];i<blockEnd[created];++i){
+          block[elements[i]]=created;
+        }
+        isWaiting.resize(blockFirst.size()*k,false);
+        const int smaller=blockEnd[c]-blockFirst[c]<=blockEnd[created]-blockFirst[created] ? c : created;
+        for(int d=0;d<k;++d){
+          const int added=isWaiting[c*k+d] ? created : smaller;
+          if(!isWaiting[added*k+d]){
+            waiting.push_back(added*k+d);
+            isWaiting[added*k+d]=true;
+          }
+        }
+      }
+      touched.clear();
+    }
+    //blocks numbered in the order of their first state, as for the other quotients
+    std::vector<int> number(blockFirst.size(),-1);
+    int count=0;
+    for(int s=0;s<n;++s){
+      if(number[block[s]]<0){
+        number[block[s]]=count++;
+      }
+      block[s]=number[block[s]];
+    }
+    return createQuotient(dfa,block,count);
+  }
+
+  FrozenAutomaton FrozenAutomaton::createMirror() const{
+    std::vector<unsigned char> flags(countStates(),0);
+    for(std::size_t s=0;s<countStates();++s){
+      flags[s]=(isFinal(s) ? Initial : 0) | (isInitial(s) ? Final : 0);
+    }
+    std::vector<Edge> edges;
+    edges.reserve(countTransitions());
+    for(std::size_t s=0;s<countStates();++s){
+      for(std::size_t a=0;a<symbols.size();++a){
+        for(int to : successors(s,a)){
+          edges.push_back(Edge{to,static_cast<int>(a),static_cast<int>(s)});
+        }
+      }
+    }
+    return FrozenAutomaton(symbols,std::vector<int>(names.begin(),names.end()),flags,edges);
+  }
+
+  /*
+  Predecessor lists of a transition relation on n states and k symbols: the
+  states with a transition to (state,symbol) are
+  sources[offsets[state*k+symbol] .. offsets[state*k+symbol+1]).
+  forEachEdge(f) calls f(from,symbol,to) on every transition, it is called twice.
+  */
+  struct Predecessors {
+    std::vector<int> offsets;
+    std::vector<int> sources;
+
+    template<class ForEachEdge>
+    Predecessors(std::size_t n,std::size_t k,const ForEachEdge& forEachEdge)
+    : offsets(n*k+1,0){
+      forEachEdge([&](int,int symbol,int to){
+        ++offsets[static_cast<std::size_t>(to)*k+symbol+1];
+      });
+      for(std::size_t i=1;i<offsets.size();++i){
+        offsets[i]+=offsets[i-1];
+      }
+      sources.resize(offsets.back());
+      std::vector<int> fill(offsets.begin(),offsets.end()-1);
+      forEachEdge([&](int from,int symbol,int to){
+        sources[fill[static_cast<std::size_t>(to)*k+symbol]++]=from;
+      });
+    }
+  };
+
+  /*
+  Subset construction of the mirror of the relation given by its predecessor
+  lists (n states, k symbols), from the set start. The subsets are numbered in
+  discovery order, accepting tells which of them intersect accept, and the
+  transitions between them are added to edges; an empty target is added as -1
+  if complete is set, left out otherwise. Returns the number of subsets.
+  */
+  static std::size_t determinizeBackward(const Predecessors& predecessors,std::size_t n,std::size_t k,const Bitset& start,const Bitset& accept,
+                                         bool complete,std::vector<FrozenAutomaton::Edge>& edges,std::vector<unsigned char>& accepting){
+    const std::size_t nwords=start.countWords();
+    SubsetTable<Bitset::Word> tab;
+    Bitset curr(n);
+    Bitset next(n);
+    tab.insert(start.data(),start.data()+nwords);
+    accepting.assign(1,start.intersects(accept));
+    for(std::size_t id=0;id<tab.size();++id){
+      std::copy(tab.begin(id),tab.end(id),curr.data());
+      for(std::size_t a=0;a<k;++a){
+        next.clear();
+        for(std::size_t s=curr.first();s<n;s=curr.next(s+1)){
+          for(int i=predecessors.offsets[s*k+a];i<predecessors.offsets[s*k+a+1];++i){
+            next.set(predecessors.sources[i]);
+          }
+        }
+        if(next.none()){
+          if(complete){
+            edges.push_back(FrozenAutomaton::Edge{static_cast<int>(id),static_cast<int>(a),-1});
+          }
+          continue;
+        }
+        std::pair<int,bool> found=tab.insert(next.data(),next.data()+nwords);
+        if(found.second){
+          accepting.push_back(next.intersects(accept));
+        }
+        edges.push_back(FrozenAutomaton::Edge{static_cast<int>(id),static_cast<int>(a),found.first});
+      }
+    }
+    return tab.size();
+  }
+
+  FrozenAutomaton FrozenAutomaton::createMinimalBrzozowski() const{
+    const std::size_t k=symbols.size();
+    std::vector<Edge> mirrorEdges;
+    std::vector<unsigned char> mirrorAccepting;
+    std::size_t mirrorStates=0;
+    if(finals.any()){
+      //the mirror determinized, from the final states; its subsets holding an initial state are its final states
+      const Predecessors predecessors(countStates(),k,[this,k](const auto& f){
+        for(std::size_t s=0;s<countStates();++s){
+          for(std::size_t a=0;a<k;++a){
+            for(int to : successors(s,a)){
+              f(static_cast<int>(s),static_cast<int>(a),to);
+            }
+          }
+        }
+      });
+      mirrorStates=determinizeBackward(predecessors,countStates(),k,finals,initials,false,mirrorEdges,mirrorAccepting);
+    }
+    Bitset start(mirrorStates);
+    for(std::size_t s=0;s<mirrorStates;++s){
+      if(mirrorAccepting[s]){
+        start.set(s);
+      }
+    }
+    if(start.none()){
+      //empty language: a single state, its own sink
+      std::vector<Edge> edges;
+      for(std::size_t a=0;a<k;++a){
+        edges.push_back(Edge{0,static_cast<int>(a),0});
+      }
+      return FrozenAutomaton(symbols,std::vector<int>(1,0),std::vector<unsigned char>(1,Initial),edges);
+    }
+    //the mirror of the first result determinized, straight from its transitions
+    const Predecessors predecessors(mirrorStates,k,[&mirrorEdges](const auto& f){
+      for(const Edge& e : mirrorEdges){
+        f(e.from,e.symbol,e.to);
+      }
+    });
+    Bitset accept(mirrorStates);
+    accept.set(0);
+    std::vector<Edge> edges;
+    std::vector<unsigned char> accepting;
+    const int count=determinizeBackward(predecessors,mirrorStates,k,start,accept,true,edges,accepting);
+    //the missing transitions go to a sink state after the others
+    bool incomplete=false;
+    for(Edge& e : edges){
+      if(e.to<0){
+        e.to=count;
+        incomplete=true;
+      }
+    }
+    std::vector<int> names(count+incomplete);
+    std::vector<unsigned char> flags(names.size(),0);
+    for(std::size_t s=0;s<names.size();++s){
+      names[s]=s;
+    }
+    for(int s=0;s<count;++s){
+      flags[s]=accepting[s] ? Final : 0;
+    }
+    flags[0]|=Initial;
+    if(incomplete){
+      for(std::size_t a=0;a<k;++a){
+        edges.push_back(Edge{count,static_cast<int>(a),count});
+      }
+    }
+    return FrozenAutomaton(symbols,names,flags,edges);
+  }
+
+  FrozenAutomaton FrozenAutomaton::createMinimal(Minimization algorithm) const{
+    switch(algorithm){
+    case Minimization::Moore:
+      return createMinimalMoore();
+    case Minimization::Brzozowski:
+      return createMinimalBrzozowski();
+    default:
+      return createMinimalHopcroft();
+    }
+  }
+
+}
@@ -0,0 +1,249 @@
+#ifndef FROZEN_AUTOMATON_H
+#define FROZEN_AUTOMATON_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Bitset.h"
+#include "FlatArray.h"
+
+namespace fa {
+
+  /**
+   * Algorithm used to build a minimal DFA
+   */
+  enum class Minimization {
+    //splitters (class,symbol) on a refinable partition, O(kn log n)
+    Hopcroft,
+    //classes split by the classes of their successors until stable, O(kn^2)
+    Moore,
+    //determinization of the mirror, twice
+    Brzozowski
+  };
+
+  /**
+   * Read-only automaton with a flat transition table.
+   *
+   * States are renumbered 0..n-1 in increasing order of their names and symbols
+   * 0..k-1 in alphabet order. The targets of (state,symbol) are stored contiguously
+   * in targets[offsets[state*k+symbol] .. offsets[state*k+symbol+1]), sorted.
+   * A FrozenAutomaton is obtained with Automaton::freeze(), or mapped from a file
+   * with loadAutomaton(). The names and the CSR table are never modified, so
+   * copies share them.
+   */
+  class FrozenAutomaton {
+  public:
+    //flags of a state, same encoding as Automaton::etats
+    static constexpr unsigned char Initial=1;
+    static constexpr unsigned char Final=2;
+
+    struct Edge{
+      int from;
+      int symbol;
+      int to;
+    };
+
+    struct StateRange{
+      const int *first;
+      const int *last;
+      const int *begin() const { return first; }
+      const int *end() const { return last; }
+      std::size_t size() const { return last-first; }
+      bool empty() const { return first==last; }
+    };
+
+    /**
+     * Build an empty frozen automaton (no state, no symbol).
+     */
+    FrozenAutomaton();
+
+    /**
+     * Build the frozen automaton from its parts.
+     *
+     * names must be sorted, flags[i] gives the flags of names[i] and the edges
+     * use dense indices. Duplicated edges are merged.
+     */
+    FrozenAutomaton(const std::vector<char>& symbols,const std::vector<int>& names,const std::vector<unsigned char>& flags,const std::vector<Edge>& edges);
+
+    /**
+     * Build the frozen automaton from arrays already in its layout: sorted names,
+     * one flag per state, countStates()*countSymbols()+1 offsets and sorted targets.
+     * The arrays are shared, not copied, and they are not checked.
+     */
+    FrozenAutomaton(const std::vector<char>& symbols,const FlatArray<int>& names,const unsigned char *flags,const FlatArray<std::uint32_t>& offsets,const FlatArray<int>& targets);
+
+    std::size_t countStates() const { return names.size(); }
+    std::size_t countSymbols() const { return symbols.size(); }
+    std::size_t countTransitions() const { return targets.size(); }
+
+    char symbol(int index) const { return symbols[index]; }
+    const std::vector<char>& alphabet() const { return symbols; }
+
+    /**
+     * Index of the symbol, -1 if the symbol is not in the alphabet
+     */
+    int symbolIndex(char symbol) const { return symbolIndices[static_cast<unsigned char>(symbol)]; }
+
+    int stateName(int index) const { return names[index]; }
+
+    //arrays of the layout, for saveAutomaton()
+    const FlatArray<int>& stateNames() const { return names; }
+    const FlatArray<std::uint32_t>& transitionOffsets() const { return offsets; }
+    const FlatArray<int>& transitionTargets() const { return targets; }
+
+    /**
+     * Index of the state, -1 if there is no state with this name
+     */
+    int stateIndex(int name) const;
+
+    bool isInitial(int index) const { return initials.test(index); }
+    bool isFinal(int index) const { return finals.test(index); }
+
+    const Bitset& initialStateSet() const { return initials; }
+    const Bitset& finalStateSet() const { return finals; }
+
+    std::size_t countInitialStates() const { return initials.count(); }
+
+    /**
+     * Tell if one of the states of the set (indexed like the automaton) is final
+     */
+    bool hasFinalState(const Bitset& states) const { return finals.intersects(states); }
+
+    /**
+     * States reached from state with the symbol (both are indices)
+     */
+    StateRange successors(int state,int symbol) const{
+      const std::size_t slot=static_cast<std::size_t>(state)*symbols.size()+symbol;
+      return StateRange{targets.data()+offsets[slot],targets.data()+offsets[slot+1]};
+    }
+
+    /**
+     * Indices of the initial states, in increasing order
+     */
+    std::vector<int> initialStates() const;
+
+    /**
+     * Tell if the automaton is deterministic (one initial state, at most one successor per symbol)
+     */
+    bool isDeterministic() const;
+
+    /**
+     * Tell if every state has a successor for every symbol
+     */
+    bool isComplete() const;
+
+    /**
+     * Set of the states reachable from the initial states
+     */
+    Bitset accessibleStates() const;
+
+    /**
+     * Check if the language of the automaton is empty
+     */
+    bool isLanguageEmpty() const;
+
+    /**
+     * Tell if the intersection with another automaton is empty.
+     *
+     * The pairs of the product are explored on the fly from the initial pairs,
+     * the product automaton is never built. The search stops at the first pair
+     * of final states.
+     */
+    bool hasEmptyIntersectionWith(const FrozenAutomaton& other) const;
+
+    /**
+     * States reached from the initial states by reading word, stepping on the
+     * transition lists (use a Matcher to read many words).
+     * The set is empty if a letter is not in the alphabet.
+     */
+    Bitset readString(const std::string& word) const;
+
+    /**
+     * Product of two automata, over the symbols they have in common ('#' if there is none).
+     *
+     * The pairs of initial states get the names 0,1... (rhs state in the outer loop),
+     * the other reachable pairs are numbered in breadth-first order. If one of the
+     * automata has no initial state, the product is a single non initial state 0.
+     */
+    static FrozenAutomaton createProduct(const FrozenAutomaton& lhs,const FrozenAutomaton& rhs);
+
+    /**
+     * Subset construction.
+     *
+     * The subset of the initial states gets the name 0, the next ones are numbered
+     * in discovery order. Empty subsets are not created, so the result may be incomplete.
+     */
+    FrozenAutomaton createDeterministic() const;
+
+    /**
+     * Quotient by the coarsest forward bisimulation: states are merged when they
+     * have the same finality and, for every symbol, successors in the same
+     * classes. Same language. A class gets the smallest name of its states and
+     * is initial if one of them is.
+     */
+    FrozenAutomaton createBisimulationQuotient() const;
+
+    /**
+     * Same language with fewer states and transitions, using the forward
+     * simulation (q' simulates q if q' is final when q is, and every transition
+     * of q is matched by a transition of q' to a state simulating its target).
+     * States simulating each other are merged, then a transition to q is dropped
+     * when the same state and symbol also lead to a state strictly simulating q,
+     * and likewise for the initial states. Non accessible states are removed.
+     */
+    FrozenAutomaton createSimulationPruned() const;
+
+    /**
+     * Minimal complete DFA of the language, with the Moore algorithm: the
+     * accessible part is determinized and completed (a sink state is added if a
+     * transition is missing), then its states are split by the classes of their
+     * successors until the partition is stable, in O(n) rounds of O(kn).
+     * A state gets the smallest name of its class in the completed DFA.
+     */
+    FrozenAutomaton createMinimalMoore() const;
+
+    /**
+     * Same automaton with the Hopcroft algorithm in O(kn log n): a refinable
+     * partition split by (class,symbol) splitters through the predecessor lists,
+     * only the smaller half of a split class becomes a new splitter.
+     */
+    FrozenAutomaton createMinimalHopcroft() const;
+
+    /**
+     * Same language with the Brzozowski algorithm: the mirror is determinized,
+     * then the mirror of the result. The first subset construction runs backward
+     * on the predecessor lists of the automaton, built once; its transitions
+     * are only kept as predecessor lists, on which the second one runs backward
+     * again, so no intermediate automaton is built. The result is completed
+     * like the other minimal automata, its states are named by the second
+     * subset construction.
+     */
+    FrozenAutomaton createMinimalBrzozowski() const;
+
+    /**
+     * Minimal complete DFA with the chosen algorithm
+     */
+    FrozenAutomaton createMinimal(Minimization algorithm) const;
+
+    /**
+     * Automaton of the mirror language: transitions reversed, initial and final
+     * states swapped
+     */
+    FrozenAutomaton createMirror() const;
+
+  private:
+    std::vector<char> symbols;
+    int symbolIndices[256];
+    //names of the states, sorted
+    FlatArray<int> names;
+    Bitset initials;
+    Bitset finals;
+    //CSR table, offsets has countStates()*countSymbols()+1 entries
+    FlatArray<std::uint32_t> offsets;
+    FlatArray<int> targets;
+  };
+
+}
+
+#endif // FROZEN_AUTOMATON_H
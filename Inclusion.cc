@@ -0,0 +1,382 @@
+#include "Inclusion.h"
+#include "SubsetTable.h"
+#include "SuccessorMasks.h"
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace fa {
+
+  /*
+  Successors of a macrostate of rhs, with the masks when rhs is small enough
+  */
+  class MacroStepper {
+  public:
+    explicit MacroStepper(const FrozenAutomaton& automaton)
+    : frozen(automaton){
+      if(automaton.countStates()<=SuccessorMasks::MaxStates){
+        masks.reset(new SuccessorMasks(automaton));
+      }
+    }
+
+    void step(const Bitset& current,int symbol,Bitset& next) const{
+      if(symbol<0){
+        next.clear();
+      }else if(masks){
+        masks->step(current,symbol,next);
+      }else{
+        next.clear();
+        for(std::size_t s=current.first();s<current.size();s=current.next(s+1)){
+          for(int to : frozen.successors(s,symbol)){
+            next.set(to);
+          }
+        }
+      }
+    }
+
+  private:
+    const FrozenAutomaton& frozen;
+    std::unique_ptr<SuccessorMasks> masks;
+  };
+
+  /*
+  Pairs met by the antichain search: for each state of lhs, the minimal macrostates met so far
+  */
+  class Antichain {
+  public:
+    explicit Antichain(std::size_t nbStates) : byState(nbStates) {}
+
+    /*
+    Add (state,macro) unless it is subsumed, it then replaces the pairs it subsumes.
+    The subsumed pairs stay in the search: being older, they may lead to a shorter word.
+    Returns the id of the new pair, -1 if it was subsumed.
+    */
+    int insert(int state,const Bitset& macro,int parent,int symbol){
+      std::vector<int>& kept=byState[state];
+      for(int id : kept){
+        if(macros[id].isSubsetOf(macro)){
+          return -1;
+        }
+      }
+      std::size_t write=0;
+      for(int id : kept){
+        if(!macro.isSubsetOf(macros[id])){
+          kept[write++]=id;
+        }
+      }
+      kept.resize(write);
+      const int id=macros.size();
+      kept.push_back(id);
+      states.push_back(state);
+      macros.push_back(macro);
+      parents.push_back(parent);
+      symbols.push_back(symbol);
+      return id;
+    }
+
+    std::vector<int> states;
+    std::vector<Bitset> macros;
+    //pair and symbol (index in lhs) the pair was reached from, -1 for the initial pairs
+    std::vector<int> parents;
+    std::vector<int> symbols;
+
+  private:
+    std::vector<std::vector<int>> byState;
+  };
+
+  bool parseInclusionEngine(const std::string& name,InclusionEngine& engine){
+    if(name=="complement"){
+      engine=InclusionEngine::Complement;
+    }else if(name=="antichain"){
+      engine=InclusionEngine::Antichain;
+    }else if(name=="hkc"){
+      engine=InclusionEngine::Hkc;
+    }else{
+      return false;
+    }
+    return true;
+  }
+
+  bool isIncludedComplement(const FrozenAutomaton& lhs,const FrozenAutomaton& rhs){
+    //rhs over the two alphabets, the symbols only lhs has lead nowhere
+    std::vector<char> symbols=rhs.alphabet();
+    for(char c : lhs.alphabet()){
+      if(rhs.symbolIndex(c)<0){
+        symbols.push_back(c);
+      }
+    }
+    std::vector<int> names(rhs.countStates());
+    std::vector<unsigned char> flags(rhs.countStates());
+    std::vector<FrozenAutomaton::Edge> edges;
+    edges.reserve(rhs.countTransitions());
+    for(std::size_t s=0;s<rhs.countStates();++s){
+      names[s]=rhs.stateName(s);
+      flags[s]=(rhs.isInitial(s) ? FrozenAutomaton::Initial : 0) | (rhs.isFinal(s) ? FrozenAutomaton::Final : 0);
+      for(std::size_t a=0;a<rhs.countSymbols();++a){
+        for(int to : rhs.successors(s,a)){
+          edges.push_back(FrozenAutomaton::Edge{static_cast<int>(s),static_cast<int>(a),to});
+        }
+      }
+    }
+    const FrozenAutomaton dfa=FrozenAutomaton(symbols,names,flags,edges).createDeterministic();
+    //symbols of lhs as seen by the DFA, which has all of them
+    std::vector<int> dfaSymbols(lhs.countSymbols());
+    for(std::size_t a=0;a<lhs.countSymbols();++a){
+      dfaSymbols[a]=dfa.symbolIndex(lhs.symbol(a));
+    }
+    //pairs (state of lhs, state of the DFA), the sink of the complement is the DFA state -1
+    const std::size_t width=dfa.countStates()+1;
+    std::vector<bool> visited(lhs.countStates()*width,false);
+    std::deque<std::pair<int,int>> queue;
+    const int start=dfa.initialStates().front();
+    for(int p : lhs.initialStates()){
+      visited[p*width+start+1]=true;
+      queue.push_back(std::make_pair(p,start));
+    }
+    while(!queue.empty()){
+      const std::pair<int,int> current=queue.front();
+      queue.pop_front();
+      if(lhs.isFinal(current.first) && (current.second<0 || !dfa.isFinal(current.second))){
+        return false;
+      }
+      for(std::size_t a=0;a<lhs.countSymbols();++a){
+        int next=-1;
+        if(current.second>=0){
+          const FrozenAutomaton::StateRange targets=dfa.successors(current.second,dfaSymbols[a]);
+          if(targets.begin()!=targets.end()){
+            next=*targets.begin();
+          }
+        }
+        for(int p : lhs.successors(current.first,a)){
+          if(!visited[p*width+next+1]){
+            visited[p*width+next+1]=true;
+            queue.push_back(std::make_pair(p,next));
+          }
+        }
+      }
+    }
+    return true;
+  }
+
+  /*
+  Breadth-first antichain search, returns the id of the first pair accepted by lhs and not by rhs, -1 if there is none
+  */
+  static int searchAntichain(const FrozenAutomaton& lhs,const FrozenAutomaton& rhs,Antichain& antichain){
+    const MacroStepper stepper(rhs);
+    //symbols of lhs as seen by rhs
+    std::vector<int> rhsSymbols(lhs.countSymbols());
+    for(std::size_t a=0;a<lhs.countSymbols();++a){
+      rhsSymbols[a]=rhs.symbolIndex(lhs.symbol(a));
+    }
+    std::deque<int> queue;
+    for(int p : lhs.initialStates()){
+      const int id=antichain.insert(p,rhs.initialStateSet(),-1,-1);
+      if(id>=0){
+        queue.push_back(id);
+      }
+    }
+    Bitset next(rhs.countStates());
+    while(!queue.empty()){
+      const int id=queue.front();
+      queue.pop_front();
+      const int p=antichain.states[id];
+      if(lhs.isFinal(p) && !rhs.hasFinalState(antichain.macros[id])){
+        return id;
+      }
+      //copy: insert may reallocate the macrostates
+      const Bitset macro=antichain.macros[id];
+      for(std::size_t a=0;a<lhs.countSymbols();++a){
+        FrozenAutomaton::StateRange targets=lhs.successors(p,a);
+        if(targets.empty()){
+          continue;
+        }
+        stepper.step(macro,rhsSymbols[a],next);
+        for(int to : targets){
+          const int child=antichain.insert(to,next,id,a);
+          if(child>=0){
+            queue.push_back(child);
+          }
+        }
+      }
+    }
+    return -1;
+  }
+
+  bool isIncludedAntichain(const FrozenAutomaton& lhs,const FrozenAutomaton& rhs){
+    Antichain antichain(lhs.countStates());
+    return searchAntichain(lhs,rhs,antichain)<0;
+  }
+
+  bool findCounterexample(const FrozenAutomaton& lhs,const FrozenAutomaton& rhs,std::string& word){
+    Antichain antichain(lhs.countStates());
+    int id=searchAntichain(lhs,rhs,antichain);
+    if(id<0){
+      return false;
+    }
+    word.clear();
+    for(;antichain.parents[id]>=0;id=antichain.parents[id]){
+      word.push_back(lhs.symbol(antichain.symbols[id]));
+    }
+    std::reverse(word.begin(),word.end());
+    return true;
+  }
+
+  /*
+  Disjoint union of lhs and rhs over the union of their alphabets: the states of lhs
+  keep their index, the index of the states of rhs is shifted by lhs.countStates()
+  */
+  static FrozenAutomaton disjointUnion(const FrozenAutomaton& lhs,const FrozenAutomaton& rhs){
+    std::vector<char> symbols=lhs.alphabet();
+    for(char c : rhs.alphabet()){
+      if(lhs.symbolIndex(c)<0){
+        symbols.push_back(c);
+      }
+    }
+    const int shift=lhs.countStates();
+    std::vector<int> names(lhs.countStates()+rhs.countStates());
+    std::vector<unsigned char> flags(names.size());
+    std::vector<FrozenAutomaton::Edge> edges;
+    edges.reserve(lhs.countTransitions()+rhs.countTransitions());
+    for(std::size_t s=0;s<names.size();++s){
+      names[s]=s;
+    }
+    const FrozenAutomaton *parts[2]={&lhs,&rhs};
+    for(int part=0;part<2;++part){
+      const FrozenAutomaton& automaton=*parts[part];
+      const int offset=part*shift;
+      for(std::size_t s=0;s<automaton.countStates();++s){
+        flags[offset+s]=(automaton.isInitial(s) ? FrozenAutomaton::Initial : 0) | (automaton.isFinal(s) ? FrozenAutomaton::Final : 0);
+        for(std::size_t a=0;a<automaton.countSymbols();++a){
+          const int symbol=std::find(symbols.begin(),symbols.end(),automaton.symbol(a))-symbols.begin();
+          for(int to : automaton.successors(s,a)){
+            edges.push_back(FrozenAutomaton::Edge{static_cast<int>(offset+s),symbol,offset+to});
+          }
+        }
+      }
+    }
+    return FrozenAutomaton(symbols,names,flags,edges);
+  }
+
+  /*
+  Union-find over the ids of the interned sets
+  */
+  class UnionFind {
+  public:
+    int find(int x){
+      while(x>=static_cast<int>(parents.size())){
+        parents.push_back(parents.size());
+      }
+      while(parents[x]!=x){
+        parents[x]=parents[parents[x]];
+        x=parents[x];
+      }
+      return x;
+    }
+
+    void merge(int x,int y){
+      parents[find(x)]=find(y);
+    }
+
+  private:
+    std::vector<int> parents;
+  };
+
+  /*
+  HKC on the sets x and y of the automaton
+  */
+  static bool equivalentSets(const FrozenAutomaton& automaton,const Bitset& x,const Bitset& y){
+    const MacroStepper stepper(automaton);
+    const std::size_t nwords=x.countWords();
+    SubsetTable<Bitset::Word> ids;
+    UnionFind classes;
+    //pairs of the relation, the rules of the rewriting system
+    std::vector<Bitset> lefts;
+    std::vector<Bitset> rights;
+    std::deque<std::pair<Bitset,Bitset>> todo;
+    todo.push_back(std::pair<Bitset,Bitset>(x,y));
+    while(!todo.empty()){
+      const Bitset left=todo.front().first;
+      const Bitset right=todo.front().second;
+      todo.pop_front();
+      //up to equivalence
+      const int leftId=ids.insert(left.data(),left.data()+nwords).first;
+      const int rightId=ids.insert(right.data(),right.data()+nwords).first;
+      if(classes.find(leftId)==classes.find(rightId)){
+        continue;
+      }
+      //up to congruence: rewrite both sets with U -> U+V and V -> U+V until saturation
+      Bitset leftForm=left;
+      Bitset rightForm=right;
+      Bitset *forms[2]={&leftForm,&rightForm};
+      for(Bitset *form : forms){
+        bool changed=true;
+        while(changed){
+          changed=false;
+          for(std::size_t r=0;r<lefts.size();++r){
+            const bool hasLeft=lefts[r].isSubsetOf(*form);
+            const bool hasRight=rights[r].isSubsetOf(*form);
+            if(hasLeft!=hasRight){
+              form->orWith(hasLeft ? rights[r] : lefts[r]);
+              changed=true;
+            }
+          }
+        }
+      }
+      if(leftForm==rightForm){
+        continue;
+      }
+      if(automaton.hasFinalState(left)!=automaton.hasFinalState(right)){
+        return false;
+      }
+      Bitset leftNext(automaton.countStates());
+      Bitset rightNext(automaton.countStates());
+      for(std::size_t a=0;a<automaton.countSymbols();++a){
+        stepper.step(left,a,leftNext);
+        stepper.step(right,a,rightNext);
+        todo.push_back(std::pair<Bitset,Bitset>(leftNext,rightNext));
+      }
+      lefts.push_back(left);
+      rights.push_back(right);
+      classes.merge(leftId,rightId);
+    }
+    return true;
+  }
+
+  bool isEquivalentHkc(const FrozenAutomaton& lhs,const FrozenAutomaton& rhs){
+    const FrozenAutomaton automaton=disjointUnion(lhs,rhs);
+    Bitset left(automaton.countStates());
+    Bitset right(automaton.countStates());
+    for(std::size_t s=automaton.initialStateSet().first();s<automaton.countStates();s=automaton.initialStateSet().next(s+1)){
+      if(s<lhs.countStates()){
+        left.set(s);
+      }else{
+        right.set(s);
+      }
+    }
+    return equivalentSets(automaton,left,right);
+  }
+
+  bool isIncludedHkc(const FrozenAutomaton& lhs,const FrozenAutomaton& rhs){
+    const FrozenAutomaton automaton=disjointUnion(lhs,rhs);
+    Bitset right(automaton.countStates());
+    for(std::size_t s=automaton.initialStateSet().first();s<automaton.countStates();s=automaton.initialStateSet().next(s+1)){
+      if(s>=lhs.countStates()){
+        right.set(s);
+      }
+    }
+    //L(lhs) is included in L(rhs) iff L(lhs)+L(rhs)=L(rhs)
+    return equivalentSets(automaton,automaton.initialStateSet(),right);
+  }
+
+  bool isIncluded(const FrozenAutomaton& lhs,const FrozenAutomaton& rhs,InclusionEngine engine){
+    if(engine==InclusionEngine::Antichain){
+      return isIncludedAntichain(lhs,rhs);
+    }
+    if(engine==InclusionEngine::Hkc){
+      return isIncludedHkc(lhs,rhs);
+    }
+    return isIncludedComplement(lhs,rhs);
+  }
+
+}
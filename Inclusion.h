@@ -0,0 +1,79 @@
+#ifndef INCLUSION_H
+#define INCLUSION_H
+
+#include <string>
+#include "FrozenAutomaton.h"
+
+namespace fa {
+
+  /**
+   * Algorithm used to decide language inclusion
+   */
+  enum class InclusionEngine {
+    //determinize and complement the right-hand side, then test the product for emptiness
+    Complement,
+    //explore (state of lhs, macrostate of rhs) pairs on the fly, pruned by an antichain
+    Antichain,
+    //bisimulation up to congruence (Bonchi and Pous) on the disjoint union of the two automata
+    Hkc
+  };
+
+  /**
+   * Engine named "complement", "antichain" or "hkc".
+   * Returns false if the name is unknown.
+   */
+  bool parseInclusionEngine(const std::string& name,InclusionEngine& engine);
+
+  /**
+   * Tell if L(lhs) is included in L(rhs) with the complement algorithm.
+   *
+   * rhs is determinized over the two alphabets, then its complement (the
+   * subsets that are not final, and the missing transitions going to a final
+   * sink) is explored on the fly in a product with lhs, breadth first, until a
+   * pair with both states final.
+   */
+  bool isIncludedComplement(const FrozenAutomaton& lhs,const FrozenAutomaton& rhs);
+
+  /**
+   * Tell if L(lhs) is included in L(rhs) with the antichain algorithm.
+   *
+   * Pairs (p,P) are explored in breadth-first order from (initial state, initial
+   * states of rhs); (p,P) is dropped when a pair (p,Q) with Q included in P was
+   * already kept. The search stops at the first pair with p final and P without
+   * final state. Symbols of lhs missing from rhs lead to the empty macrostate.
+   */
+  bool isIncludedAntichain(const FrozenAutomaton& lhs,const FrozenAutomaton& rhs);
+
+  /**
+   * Tell if L(lhs) is not included in L(rhs), and give the witness.
+   *
+   * Same search as isIncludedAntichain, each pair remembers the pair and the
+   * symbol it comes from. word gets a shortest word of L(lhs)\L(rhs).
+   */
+  bool findCounterexample(const FrozenAutomaton& lhs,const FrozenAutomaton& rhs,std::string& word);
+
+  /**
+   * Tell if L(lhs) equals L(rhs) with the HKC algorithm.
+   *
+   * Pairs of sets of states of the disjoint union of lhs and rhs are explored
+   * from (initial states of lhs, initial states of rhs). A pair is skipped when
+   * its two sets are already related by the equivalence closure of the pairs met
+   * so far (union-find), or by their congruence closure (both sets rewrite to the
+   * same normal form). Nothing is determinized.
+   */
+  bool isEquivalentHkc(const FrozenAutomaton& lhs,const FrozenAutomaton& rhs);
+
+  /**
+   * Tell if L(lhs) is included in L(rhs) with the HKC algorithm,
+   * as the equivalence of the sets I1+I2 and I2 of the disjoint union.
+   */
+  bool isIncludedHkc(const FrozenAutomaton& lhs,const FrozenAutomaton& rhs);
+
+  /**
+   * Tell if L(lhs) is included in L(rhs) with the given engine.
+   */
+  bool isIncluded(const FrozenAutomaton& lhs,const FrozenAutomaton& rhs,InclusionEngine engine);
+
+}
+
+#endif // INCLUSION_H
@@ -0,0 +1,303 @@
+#include "InclusionEncoder.h"
+#include <cstdlib>
+
+namespace fa {
+
+  InclusionEncoder::InclusionEncoder(const FrozenAutomaton& lhs,const FrozenAutomaton& rhs,int length,AmoEncoding encoding,LetterEncoding letters)
+  : lhs(lhs),rhs(rhs),length(length),encoding(encoding),letters(letters),symbols(lhs.alphabet()){
+    for(char c : rhs.alphabet()){
+      if(lhs.symbolIndex(c)<0){
+        symbols.push_back(c);
+      }
+    }
+    for(char c : symbols){
+      lhsSymbols.push_back(lhs.symbolIndex(c));
+      rhsSymbols.push_back(rhs.symbolIndex(c));
+    }
+    const int k=symbols.size();
+    letterAux=0;
+    if(letters==LetterEncoding::OneHot){
+      letterWidth=k;
+      letterAux=countAmoVariables(k,encoding);
+    }else{
+      letterWidth=0;
+      while((1<<letterWidth)<k){
+        letterWidth++;
+      }
+    }
+    std::vector<Bitset> lhsKeep(length+1,Bitset(lhs.countStates()));
+    std::vector<Bitset> rhsKeep(length+1,Bitset(rhs.countStates()));
+    for(int step=0;step<=length;++step){
+      for(std::size_t s=0;s<lhs.countStates();++s){
+        lhsKeep[step].set(s);
+      }
+      for(std::size_t s=0;s<rhs.countStates();++s){
+        rhsKeep[step].set(s);
+      }
+    }
+    number(lhsKeep,rhsKeep);
+  }
+
+  void InclusionEncoder::number(const std::vector<Bitset>& lhsKeep,const std::vector<Bitset>& rhsKeep){
+    int next=letterWidth*length+1;
+    lhsVariables.assign(lhs.countStates()*(length+1),0);
+    for(std::size_t s=0;s<lhs.countStates();++s){
+      for(int step=0;step<=length;++step){
+        if(lhsKeep[step].test(s)){
+          lhsVariables[s*(length+1)+step]=next++;
+        }
+      }
+    }
+    rhsVariables.assign(rhs.countStates()*(length+1),0);
+    for(std::size_t s=0;s<rhs.countStates();++s){
+      for(int step=0;step<=length;++step){
+        if(rhsKeep[step].test(s)){
+          rhsVariables[s*(length+1)+step]=next++;
+        }
+      }
+    }
+    auxFirst.resize(length+1);
+    stateAux.resize(length+1);
+    for(int step=0;step<=length;++step){
+      auxFirst[step]=next;
+      stateAux[step]=countAmoVariables(lhsKeep[step].count(),encoding);
+      next+=stateAux[step]+letterAux;
+    }
+    variables=next-1;
+  }
+
+  /*
+  States reached after exactly i letters, for i=0..length
+  */
+  static std::vector<Bitset> forwardLayers(const FrozenAutomaton& automaton,const std::vector<int>& usable,int length){
+    std::vector<Bitset> layers(length+1,Bitset(automaton.countStates()));
+    layers[0]=automaton.initialStateSet();
+    for(int step=0;step<length;++step){
+      const Bitset& current=layers[step];
+      for(std::size_t s=current.first();s<current.size();s=current.next(s+1)){
+        for(int a : usable){
+          for(int to : automaton.successors(s,a)){
+            layers[step+1].set(to);
+          }
+        }
+      }
+    }
+    return layers;
+  }
+
+  /*
+  States reaching a final state after exactly length-i letters, or after at most length-i letters
+  */
+  static std::vector<Bitset> backwardLayers(const FrozenAutomaton& automaton,const std::vector<int>& usable,int length,bool exactLength){
+    std::vector<Bitset> layers(length+1,Bitset(automaton.countStates()));
+    layers[length]=automaton.finalStateSet();
+    for(int step=length-1;step>=0;--step){
+      if(!exactLength){
+        layers[step]=automaton.finalStateSet();
+      }
+      for(std::size_t s=0;s<automaton.countStates();++s){
+        bool found=false;
+        for(std::size_t i=0;i<usable.size() && !found;++i){
+          for(int to : automaton.successors(s,usable[i])){
+            if(layers[step+1].test(to)){
+              found=true;
+              break;
+            }
+          }
+        }
+        if(found){
+          layers[step].set(s);
+        }
+      }
+    }
+    return layers;
+  }
+
+  void InclusionEncoder::trim(bool exactLength){
+    //the letters of a counterexample are symbols of lhs
+    std::vector<int> lhsUsable;
+    std::vector<int> rhsUsable;
+    for(std::size_t a=0;a<symbols.size();++a){
+      if(lhsSymbols[a]>=0){
+        lhsUsable.push_back(lhsSymbols[a]);
+        if(rhsSymbols[a]>=0){
+          rhsUsable.push_back(rhsSymbols[a]);
+        }
+      }
+    }
+    std::vector<Bitset> lhsKeep=forwardLayers(lhs,lhsUsable,length);
+    std::vector<Bitset> lhsEnd=backwardLayers(lhs,lhsUsable,length,exactLength);
+    std::vector<Bitset> rhsKeep=forwardLayers(rhs,rhsUsable,length);
+    std::vector<Bitset> rhsEnd=backwardLayers(rhs,rhsUsable,length,exactLength);
+    for(int step=0;step<=length;++step){
+      lhsKeep[step].andWith(lhsEnd[step]);
+      rhsKeep[step].andWith(rhsEnd[step]);
+    }
+    number(lhsKeep,rhsKeep);
+  }
+
+  std::vector<int> InclusionEncoder::letterLiterals(int symbol,int position) const{
+    if(letters==LetterEncoding::OneHot){
+      return std::vector<int>(1,symbol*length+position);
+    }
+    std::vector<int> res(letterWidth);
+    for(int bit=0;bit<letterWidth;++bit){
+      const int v=bit*length+position;
+      res[bit]=(symbol>>bit)&1 ? v : -v;
+    }
+    return res;
+  }
+
+  void InclusionEncoder::encodeStep(ClauseSink& sink,int step) const{
+    const int n1=lhs.countStates();
+    const int n2=rhs.countStates();
+    const int k=symbols.size();
+    std::vector<int> clause;
+    if(step==0){
+      //lhs starts with an initial state
+      for(int s : lhs.initialStates()){
+        if(lhsVariable(s,0)!=0){
+          clause.push_back(lhsVariable(s,0));
+        }
+      }
+      sink.addClause(clause);
+      //rhs starts with all its initial states
+      for(int s : rhs.initialStates()){
+        if(rhsVariable(s,0)!=0){
+          sink.addClause({rhsVariable(s,0)});
+        }
+      }
+    }else{
+      //exactly one letter at this position
+      std::vector<std::vector<int>> read(k);
+      for(int a=0;a<k;++a){
+        read[a]=letterLiterals(a,step);
+      }
+      if(letters==LetterEncoding::OneHot){
+        clause.clear();
+        for(int a=0;a<k;++a){
+          clause.push_back(read[a][0]);
+        }
+        addExactlyOne(sink,clause,encoding,auxFirst[step]+stateAux[step]);
+      }else{
+        for(int code=k;code<(1<<letterWidth);++code){
+          clause.clear();
+          for(int l : letterLiterals(code,step)){
+            clause.push_back(-l);
+          }
+          sink.addClause(clause);
+        }
+      }
+      //the word follows lhs's transitions, trimmed states are never taken
+      for(int s=0;s<n1;++s){
+        if(lhsVariable(s,step-1)==0){
+          continue;
+        }
+        for(int a=0;a<k;++a){
+          clause.assign(1,-lhsVariable(s,step-1));
+          for(int l : read[a]){
+            clause.push_back(-l);
+          }
+          if(lhsSymbols[a]>=0){
+            for(int to : lhs.successors(s,lhsSymbols[a])){
+              if(lhsVariable(to,step)!=0){
+                clause.push_back(lhsVariable(to,step));
+              }
+            }
+          }
+          sink.addClause(clause);
+        }
+      }
+      //accessible states of rhs, trimmed states cannot lead to a final state
+      for(int s=0;s<n2;++s){
+        if(rhsVariable(s,step-1)==0){
+          continue;
+        }
+        for(int a=0;a<k;++a){
+          if(rhsSymbols[a]<0){
+            continue;
+          }
+          for(int to : rhs.successors(s,rhsSymbols[a])){
+            if(rhsVariable(to,step)==0){
+              continue;
+            }
+            clause.assign(1,-rhsVariable(s,step-1));
+            for(int l : read[a]){
+              clause.push_back(-l);
+            }
+            clause.push_back(rhsVariable(to,step));
+            sink.addClause(clause);
+          }
+        }
+      }
+    }
+    //exactly one state of lhs at this step
+    clause.clear();
+    for(int s=0;s<n1;++s){
+      if(lhsVariable(s,step)!=0){
+        clause.push_back(lhsVariable(s,step));
+      }
+    }
+    addExactlyOne(sink,clause,encoding,auxFirst[step]);
+  }
+
+  void InclusionEncoder::encodeEnd(ClauseSink& sink,int step,int guard) const{
+    std::vector<int> clause;
+    if(guard!=0){
+      clause.push_back(-guard);
+    }
+    for(std::size_t s=0;s<lhs.countStates();++s){
+      if(lhs.isFinal(s) && lhsVariable(s,step)!=0){
+        clause.push_back(lhsVariable(s,step));
+      }
+    }
+    sink.addClause(clause);
+    for(std::size_t s=0;s<rhs.countStates();++s){
+      if(rhs.isFinal(s) && rhsVariable(s,step)!=0){
+        if(guard!=0){
+          sink.addClause({-guard,-rhsVariable(s,step)});
+        }else{
+          sink.addClause({-rhsVariable(s,step)});
+        }
+      }
+    }
+  }
+
+  void InclusionEncoder::encode(ClauseSink& sink) const{
+    sink.reserveVariables(countVariables());
+    for(int step=0;step<=length;++step){
+      encodeStep(sink,step);
+    }
+    encodeEnd(sink,length);
+  }
+
+  std::string InclusionEncoder::decodeWord(const SatSolver& solver,int count) const{
+    std::vector<bool> model(letterWidth*length);
+    for(std::size_t v=0;v<model.size();++v){
+      model[v]=solver.modelValue(v+1);
+    }
+    return decodeWord(model,count);
+  }
+
+  std::string InclusionEncoder::decodeWord(const std::vector<bool>& model,int count) const{
+    std::string word;
+    for(int i=1;i<=count;++i){
+      for(std::size_t a=0;a<symbols.size();++a){
+        bool holds=true;
+        for(int l : letterLiterals(a,i)){
+          const std::size_t v=std::abs(l);
+          if((v<=model.size() && model[v-1])!=(l>0)){
+            holds=false;
+            break;
+          }
+        }
+        if(holds){
+          word.push_back(symbols[a]);
+          break;
+        }
+      }
+    }
+    return word;
+  }
+
+}
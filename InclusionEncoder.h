@@ -0,0 +1,135 @@
+#ifndef INCLUSION_ENCODER_H
+#define INCLUSION_ENCODER_H
+
+#include <string>
+#include <vector>
+#include "Cardinality.h"
+#include "FrozenAutomaton.h"
+#include "SatSolver.h"
+
+namespace fa {
+
+  /**
+   * Variables used for the letter at a position of the word
+   */
+  enum class LetterEncoding {
+    //one variable per symbol, exactly one of them is true
+    OneHot,
+    //the index of the symbol written on log2(k) variables, the unused codes excluded
+    Logarithmic
+  };
+
+  /**
+   * Clauses satisfiable iff a word of the given length is accepted by lhs and
+   * not by rhs.
+   *
+   * The word is over the symbols of lhs followed by the symbols of rhs that lhs
+   * does not have. The variables are numbered in four blocks:
+   *  - letter variables, for each symbol (one-hot) or each bit of the symbol
+   *    index (logarithmic), then each position 1..length;
+   *  - a state of lhs at a step 0..length, for each state then each step;
+   *  - a state of rhs at a step, in the same order;
+   *  - auxiliary variables of the "exactly one" constraints (one state of lhs
+   *    and one letter), for each step.
+   * States are the dense indices of the frozen automata. trim() removes the
+   * state variables that cannot take part in a counterexample, the others are
+   * numbered in the same order.
+   */
+  class InclusionEncoder {
+  public:
+    InclusionEncoder(const FrozenAutomaton& lhs,const FrozenAutomaton& rhs,int length,AmoEncoding encoding=AmoEncoding::Pairwise,LetterEncoding letters=LetterEncoding::OneHot);
+
+    int getLength() const { return length; }
+    int countVariables() const { return variables; }
+
+    /**
+     * Symbols of the words, in the order of their indices
+     */
+    const std::vector<char>& alphabet() const { return symbols; }
+
+    /**
+     * Literals whose conjunction means that the symbol (index in alphabet()) is
+     * at the position (1..length) of the word
+     */
+    std::vector<int> letterLiterals(int symbol,int position) const;
+
+    /**
+     * The run of lhs is in the state after step (0..length) letters, 0 if the
+     * variable was trimmed
+     */
+    int lhsVariable(int state,int step) const { return lhsVariables[state*(length+1)+step]; }
+
+    /**
+     * A run of rhs can be in the state after step letters, 0 if the variable was
+     * trimmed
+     */
+    int rhsVariable(int state,int step) const { return rhsVariables[state*(length+1)+step]; }
+
+    /**
+     * Keep only the state variables of the states reachable after step letters
+     * (of lhs for the states of lhs, of both for the states of rhs) and able to
+     * reach a final state with the remaining letters. With exactLength, the word
+     * ends at step length. Otherwise the word can end at any step (incremental
+     * search with encodeEnd), a state only has to reach a final state within the
+     * remaining letters.
+     */
+    void trim(bool exactLength=true);
+
+    /**
+     * Clauses of a step: the initial states for step 0, otherwise the letter at
+     * position step and the transitions from step-1. Steps are encoded in order.
+     */
+    void encodeStep(ClauseSink& sink,int step) const;
+
+    /**
+     * Clauses saying that the word ends at step: lhs in a final state and no run
+     * of rhs in one. If guard is not 0, each clause gets the literal -guard.
+     */
+    void encodeEnd(ClauseSink& sink,int step,int guard=0) const;
+
+    /**
+     * Every clause for a word of exactly length letters
+     */
+    void encode(ClauseSink& sink) const;
+
+    /**
+     * Word of the first letters of the model found by the solver
+     */
+    std::string decodeWord(const SatSolver& solver,int count) const;
+
+    /**
+     * Same with the model given as the values of the variables 1,2... (model[v-1]
+     * for v), missing variables are false
+     */
+    std::string decodeWord(const std::vector<bool>& model,int count) const;
+
+  private:
+    const FrozenAutomaton& lhs;
+    const FrozenAutomaton& rhs;
+    int length;
+    AmoEncoding encoding;
+    LetterEncoding letters;
+    std::vector<char> symbols;
+    //index in lhs and in rhs of each symbol, -1 if the automaton does not have it
+    std::vector<int> lhsSymbols;
+    std::vector<int> rhsSymbols;
+    //letter variables per position
+    int letterWidth;
+    //state variables by state then step, 0 when trimmed
+    std::vector<int> lhsVariables;
+    std::vector<int> rhsVariables;
+    //first auxiliary variable of each step, for the states of lhs then the letters
+    std::vector<int> auxFirst;
+    std::vector<int> stateAux;
+    int letterAux;
+    int variables;
+
+    /**
+     * Number the variables of the states set in keep (one set per step)
+     */
+    void number(const std::vector<Bitset>& lhsKeep,const std::vector<Bitset>& rhsKeep);
+  };
+
+}
+
+#endif // INCLUSION_ENCODER_H
@@ -0,0 +1,223 @@
+#include "Matcher.h"
+#include <algorithm>
+
+namespace fa {
+
+  Matcher::Matcher(const FrozenAutomaton& automaton,std::size_t cacheBytes)
+  : frozen(automaton),deterministic(automaton.isDeterministic()),initial(-1),nwords(Bitset(automaton.countStates()).countWords()),
+    scratch(nwords),flushes(0),budget(cacheBytes){
+    const std::size_t k=frozen.countSymbols();
+    if(deterministic){
+      initial=frozen.initialStates().front();
+      table.assign(frozen.countStates()*k,-1);
+      for(std::size_t s=0;s<frozen.countStates();++s){
+        for(std::size_t a=0;a<k;++a){
+          FrozenAutomaton::StateRange range=frozen.successors(s,a);
+          if(!range.empty()){
+            table[s*k+a]=*range.begin();
+          }
+        }
+      }
+    }else{
+      if(frozen.countStates()<=SuccessorMasks::MaxStates){
+        //the masks point to the copy owned by the matcher
+        masks.reset(new SuccessorMasks(frozen));
+      }
+      flush();
+    }
+  }
+
+  void Matcher::step(const Bitset::Word *current,int symbol,Bitset::Word *next) const{
+    if(masks){
+      masks->step(current,symbol,next);
+      return;
+    }
+    std::fill(next,next+nwords,0);
+    for(std::size_t w=0;w<nwords;++w){
+      for(Bitset::Word bits=current[w];bits!=0;bits&=bits-1){
+        for(int to : frozen.successors(w*Bitset::WordBits+__builtin_ctzll(bits),symbol)){
+          next[to/Bitset::WordBits]|=Bitset::Word(1)<<(to%Bitset::WordBits);
+        }
+      }
+    }
+  }
+
+  bool Matcher::isAccepting(const Bitset::Word *current) const{
+    const Bitset::Word *finals=frozen.finalStateSet().data();
+    for(std::size_t w=0;w<nwords;++w){
+      if(current[w]&finals[w]){
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void Matcher::flush() const{
+    const Bitset::Word *init=frozen.initialStateSet().data();
+    subsets.clear();
+    subsets.insert(init,init+nwords);
+    transitions.assign(frozen.countSymbols(),Unknown);
+    accepting.assign(1,isAccepting(init));
+  }
+
+  int Matcher::transition(int state,int symbol) const{
+    const std::size_t k=frozen.countSymbols();
+    step(subsets.begin(state),symbol,scratch.data());
+    int to=-1;
+    if(std::any_of(scratch.begin(),scratch.end(),[](Bitset::Word w){ return w!=0; })){
+      to=subsets.find(scratch.data(),scratch.data()+nwords);
+      if(to<0){
+        //the subset, its row, its hash and two slots of the table
+        const std::size_t stateBytes=nwords*sizeof(Bitset::Word)+k*sizeof(int)+1+sizeof(std::size_t)+sizeof(std::uint64_t)+2*sizeof(int);
+        if((subsets.size()+1)*stateBytes>budget){
+          flush();
+          ++flushes;
+          return Overflow;
+        }
+        to=subsets.insert(scratch.data(),scratch.data()+nwords).first;
+        transitions.resize(transitions.size()+k,Unknown);
+        accepting.push_back(isAccepting(scratch.data()));
+      }
+    }
+    transitions[state*k+symbol]=to;
+    return to;
+  }
+
+  bool Matcher::matchSets(std::vector<Bitset::Word>& current,std::string_view rest) const{
+    std::vector<Bitset::Word> next(nwords);
+    for(char c : rest){
+      const int symbol=frozen.symbolIndex(c);
+      if(symbol<0){
+        return false;
+      }
+      step(current.data(),symbol,next.data());
+      current.swap(next);
+    }
+    return isAccepting(current.data());
+  }
+
+  bool Matcher::match(std::string_view word) const{
+    if(deterministic){
+      const std::size_t k=frozen.countSymbols();
+      int state=initial;
+      for(char c : word){
+        const int symbol=frozen.symbolIndex(c);
+        if(symbol<0){
+          return false;
+        }
+        state=table[state*k+symbol];
+        if(state<0){
+          return false;
+        }
+      }
+      return frozen.isFinal(state);
+    }
+    const std::size_t k=frozen.countSymbols();
+    int state=0;
+    for(std::size_t i=0;i<word.size();++i){
+      const int symbol=frozen.symbolIndex(word[i]);
+      if(symbol<0){
+        return false;
+      }
+      int to=transitions[state*k+symbol];
+      if(to==Unknown){
+        to=transition(state,symbol);
+      }
+      if(to==Overflow){
+        std::vector<Bitset::Word> current(scratch);
+        return matchSets(current,word.substr(i+1));
+      }
+      if(to<0){
+        return false;
+      }
+      state=to;
+    }
+    return accepting[state];
+  }
+
+  /*
+  Length of the longest word of a group
+  */
+  static std::size_t longest(const std::string_view *words,std::size_t count){
+    std::size_t res=0;
+    for(std::size_t j=0;j<count;++j){
+      res=std::max(res,words[j].size());
+    }
+    return res;
+  }
+
+  void Matcher::matchDeterministic(const std::string_view *words,std::size_t count,Bitset& result,std::size_t first) const{
+    const std::size_t k=frozen.countSymbols();
+    int states[BatchSize];
+    std::fill(states,states+count,initial);
+    const std::size_t length=longest(words,count);
+    for(std::size_t i=0;i<length;++i){
+      for(std::size_t j=0;j<count;++j){
+        if(states[j]<0 || i>=words[j].size()){
+          continue;
+        }
+        const int symbol=frozen.symbolIndex(words[j][i]);
+        states[j]=symbol<0 ? -1 : table[states[j]*k+symbol];
+      }
+    }
+    for(std::size_t j=0;j<count;++j){
+      if(states[j]>=0 && frozen.isFinal(states[j])){
+        result.set(first+j);
+      }
+    }
+  }
+
+  bool Matcher::matchLazy(const std::string_view *words,std::size_t count,Bitset& result,std::size_t first) const{
+    const std::size_t k=frozen.countSymbols();
+    int states[BatchSize];
+    std::fill(states,states+count,0);
+    const std::size_t length=longest(words,count);
+    for(std::size_t i=0;i<length;++i){
+      for(std::size_t j=0;j<count;++j){
+        if(states[j]<0 || i>=words[j].size()){
+          continue;
+        }
+        const int symbol=frozen.symbolIndex(words[j][i]);
+        if(symbol<0){
+          states[j]=-1;
+          continue;
+        }
+        int to=transitions[states[j]*k+symbol];
+        if(to==Unknown){
+          to=transition(states[j],symbol);
+        }
+        //the flush lost the states of the other words of the group
+        if(to==Overflow){
+          return false;
+        }
+        states[j]=to;
+      }
+    }
+    for(std::size_t j=0;j<count;++j){
+      if(states[j]>=0 && accepting[states[j]]){
+        result.set(first+j);
+      }
+    }
+    return true;
+  }
+
+  Bitset Matcher::matchBatch(const std::vector<std::string_view>& words) const{
+    Bitset result(words.size());
+    for(std::size_t first=0;first<words.size();first+=BatchSize){
+      const std::size_t count=std::min(BatchSize,words.size()-first);
+      if(deterministic){
+        matchDeterministic(words.data()+first,count,result,first);
+      }else if(!matchLazy(words.data()+first,count,result,first)){
+        const Bitset& init=frozen.initialStateSet();
+        for(std::size_t j=0;j<count;++j){
+          std::vector<Bitset::Word> current(init.data(),init.data()+nwords);
+          if(matchSets(current,words[first+j])){
+            result.set(first+j);
+          }
+        }
+      }
+    }
+    return result;
+  }
+
+}
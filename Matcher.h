@@ -0,0 +1,109 @@
+#ifndef MATCHER_H
+#define MATCHER_H
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+#include "Bitset.h"
+#include "FrozenAutomaton.h"
+#include "SubsetTable.h"
+#include "SuccessorMasks.h"
+
+namespace fa {
+
+  /**
+   * Automaton compiled to classify words.
+   *
+   * A deterministic automaton is run on a transition table, one state per word.
+   * Otherwise the subset construction is done lazily: a set of active states
+   * gets a DFA state id the first time it is reached, and its transitions are
+   * filled in as they are first taken. The sets are stepped with the successor
+   * masks (or the transition lists above SuccessorMasks::MaxStates states).
+   * When the cache goes over its budget it is flushed, and the word being read
+   * is finished on the bitsets.
+   *
+   * The cache is updated by the const methods: a matcher must not be shared
+   * between threads.
+   */
+  class Matcher {
+  public:
+    //words run together by matchBatch
+    static constexpr std::size_t BatchSize=64;
+
+    //default budget of the DFA cache, in bytes
+    static constexpr std::size_t DefaultCacheBytes=8<<20;
+
+    explicit Matcher(const FrozenAutomaton& automaton,std::size_t cacheBytes=DefaultCacheBytes);
+
+    Matcher(const Matcher&)=delete;
+    Matcher& operator=(const Matcher&)=delete;
+
+    const FrozenAutomaton& automaton() const { return frozen; }
+
+    /**
+     * Tell if the word is accepted
+     */
+    bool match(std::string_view word) const;
+
+    /**
+     * Bit i of the result tells if words[i] is accepted.
+     *
+     * The words are read in groups of BatchSize, one letter of every word of the
+     * group at a time, so the hot rows of the table are shared by the group. A
+     * group during which the DFA cache is flushed is read again on the bitsets.
+     */
+    Bitset matchBatch(const std::vector<std::string_view>& words) const;
+
+    /**
+     * Number of DFA states in the cache, and number of flushes of the cache
+     */
+    std::size_t countCachedStates() const { return subsets.size(); }
+    std::size_t countFlushes() const { return flushes; }
+
+  private:
+    FrozenAutomaton frozen;
+    bool deterministic;
+    //deterministic case: the initial state and the successor of (state,symbol), -1 if none
+    int initial;
+    std::vector<int> table;
+    //other case: masks for the small automata, null for the large ones
+    std::unique_ptr<SuccessorMasks> masks;
+    std::size_t nwords;
+    //lazy DFA: the subset of every cached state (the initial one is 0), and the
+    //target of (state,symbol), Unknown if not computed yet, -1 if the set is empty
+    mutable SubsetTable<Bitset::Word> subsets;
+    mutable std::vector<int> transitions;
+    mutable std::vector<unsigned char> accepting;
+    //the last set computed by transition()
+    mutable std::vector<Bitset::Word> scratch;
+    mutable std::size_t flushes;
+    std::size_t budget;
+
+    static constexpr int Unknown=-2;
+    static constexpr int Overflow=-3;
+
+    void step(const Bitset::Word *current,int symbol,Bitset::Word *next) const;
+    bool isAccepting(const Bitset::Word *current) const;
+    /**
+     * Empty the cache, but for the initial state
+     */
+    void flush() const;
+    /**
+     * Target of the transition of the cached state, computed if needed.
+     * Returns Overflow, with the cache flushed, if the target does not fit in
+     * the budget; the target set is then left in scratch.
+     */
+    int transition(int state,int symbol) const;
+    /**
+     * Read the rest of a word from the set current, without the cache
+     */
+    bool matchSets(std::vector<Bitset::Word>& current,std::string_view rest) const;
+    void matchDeterministic(const std::string_view *words,std::size_t count,Bitset& result,std::size_t first) const;
+    bool matchLazy(const std::string_view *words,std::size_t count,Bitset& result,std::size_t first) const;
+    void matchSets(const std::string_view *words,std::size_t count,Bitset& result,std::size_t first) const;
+  };
+
+}
+
+#endif // MATCHER_H
@@ -0,0 +1,97 @@
+#ifndef PAIR_TABLE_H
+#define PAIR_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace fa {
+
+  /**
+   * Pairs of state indices, numbered 0,1,2... in insertion order.
+   *
+   * A pair (p,q) is stored as the 64-bit key p<<32|q in an open-addressing hash table.
+   */
+  class PairTable {
+  public:
+    PairTable() : keys(16,Empty),ids(16,-1),count(0) {}
+
+    static std::uint64_t key(int p,int q){
+      return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(p))<<32)|static_cast<std::uint32_t>(q);
+    }
+    static int first(std::uint64_t key) { return static_cast<int>(key>>32); }
+    static int second(std::uint64_t key) { return static_cast<int>(key&0xffffffffULL); }
+
+    std::size_t size() const { return count; }
+
+    /**
+     * Id of the pair, -1 if it was never inserted
+     */
+    int find(int p,int q) const{
+      const std::uint64_t k=key(p,q);
+      for(std::size_t i=slot(k);keys[i]!=Empty;i=(i+1)&(keys.size()-1)){
+        if(keys[i]==k){
+          return ids[i];
+        }
+      }
+      return -1;
+    }
+
+    /**
+     * Id of the pair, inserted if it was not already present.
+     * The second member tells if the pair was inserted.
+     */
+    std::pair<int,bool> insert(int p,int q){
+      const std::uint64_t k=key(p,q);
+      std::size_t i=slot(k);
+      for(;keys[i]!=Empty;i=(i+1)&(keys.size()-1)){
+        if(keys[i]==k){
+          return std::pair<int,bool>(ids[i],false);
+        }
+      }
+      const int id=count++;
+      keys[i]=k;
+      ids[i]=id;
+      //keep the load factor under 1/2
+      if(2*count>keys.size()){
+        grow();
+      }
+      return std::pair<int,bool>(id,true);
+    }
+
+  private:
+    static constexpr std::uint64_t Empty=~std::uint64_t(0);
+
+    std::size_t slot(std::uint64_t k) const{
+      k^=k>>33;
+      k*=0xff51afd7ed558ccdULL;
+      k^=k>>33;
+      return k&(keys.size()-1);
+    }
+
+    void grow(){
+      std::vector<std::uint64_t> oldKeys(2*keys.size(),Empty);
+      std::vector<int> oldIds(2*ids.size(),-1);
+      oldKeys.swap(keys);
+      oldIds.swap(ids);
+      for(std::size_t j=0;j<oldKeys.size();++j){
+        if(oldKeys[j]!=Empty){
+          std::size_t i=slot(oldKeys[j]);
+          while(keys[i]!=Empty){
+            i=(i+1)&(keys.size()-1);
+          }
+          keys[i]=oldKeys[j];
+          ids[i]=oldIds[j];
+        }
+      }
+    }
+
+    std::vector<std::uint64_t> keys;
+    std::vector<int> ids;
+    std::size_t count;
+  };
+
+}
+
+#endif // PAIR_TABLE_H
@@ -0,0 +1,556 @@
+#include "SatSolver.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+
+namespace fa {
+
+  /*
+  Luby sequence 1 1 2 1 1 2 4 1 1 2 ... scaled by y^i, used for the restarts
+  */
+  static double luby(double y,int x){
+    int size=1;
+    int seq=0;
+    while(size<x+1){
+      seq++;
+      size=2*size+1;
+    }
+    while(size-1!=x){
+      size=(size-1)>>1;
+      seq--;
+      x=x%size;
+    }
+    double res=1;
+    for(int i=0;i<seq;++i){
+      res*=y;
+    }
+    return res;
+  }
+
+  CdclSolver::CdclSolver()
+  : ok(true),wasted(0),propagated(0),variableIncrement(1),clauseIncrement(1),maxLearnts(0),conflicts(0){
+  }
+
+  void CdclSolver::reserveVariables(int count){
+    while(static_cast<int>(assigns.size())<count){
+      const int v=assigns.size();
+      assigns.push_back(Undef);
+      polarity.push_back(true);
+      levels.push_back(0);
+      reasons.push_back(NoClause);
+      activity.push_back(0);
+      heapIndex.push_back(-1);
+      seen.push_back(0);
+      watches.push_back(std::vector<Watcher>());
+      watches.push_back(std::vector<Watcher>());
+      heapInsert(v);
+    }
+  }
+
+  CdclSolver::ClauseRef CdclSolver::allocClause(const std::vector<Lit>& lits,bool learnt){
+    const ClauseRef c=arena.size();
+    arena.push_back(lits.size());
+    arena.push_back(learnt);
+    arena.push_back(0);
+    clauseActivity(c)=0;
+    arena.insert(arena.end(),lits.begin(),lits.end());
+    return c;
+  }
+
+  void CdclSolver::attachClause(ClauseRef c){
+    Lit *lits=literals(c);
+    watches[lits[0]^1].push_back(Watcher{c,lits[1]});
+    watches[lits[1]^1].push_back(Watcher{c,lits[0]});
+  }
+
+  bool CdclSolver::isLocked(ClauseRef c){
+    const Lit first=literals(c)[0];
+    return value(first)==True && reasons[var(first)]==c;
+  }
+
+  void CdclSolver::addClause(const std::vector<int>& literals){
+    if(!ok){
+      return;
+    }
+    cancelUntil(0);
+    std::vector<Lit> lits;
+    lits.reserve(literals.size());
+    for(int l : literals){
+      reserveVariables(std::abs(l));
+      lits.push_back(toLit(l));
+    }
+    std::sort(lits.begin(),lits.end());
+    std::size_t write=0;
+    for(std::size_t i=0;i<lits.size();++i){
+      const Lit p=lits[i];
+      if(value(p)==True || (write>0 && lits[write-1]==(p^1))){
+        //satisfied or tautology
+        return;
+      }
+      if(value(p)!=False && (write==0 || lits[write-1]!=p)){
+        lits[write++]=p;
+      }
+    }
+    lits.resize(write);
+    if(lits.empty()){
+      ok=false;
+    }else if(lits.size()==1){
+      enqueue(lits[0],NoClause);
+      ok=(propagate()==NoClause);
+    }else{
+      attachClause(allocClause(lits,false));
+    }
+  }
+
+  void CdclSolver::enqueue(Lit p,ClauseRef from){
+    assigns[var(p)]=sign(p) ? False : True;
+    levels[var(p)]=decisionLevel();
+    reasons[var(p)]=from;
+    trail.push_back(p);
+  }
+
+  CdclSolver::ClauseRef CdclSolver::propagate(){
+    ClauseRef conflict=NoClause;
+    while(propagated<trail.size()){
+      const Lit p=trail[propagated++];
+      std::vector<Watcher>& ws=watches[p];
+      std::size_t i=0;
+      std::size_t j=0;
+      while(i<ws.size()){
+        if(value(ws[i].blocker)==True){
+          ws[j++]=ws[i++];
+          continue;
+        }
+        const ClauseRef c=ws[i].clause;
+        Lit *lits=literals(c);
+        const Lit falseLit=p^1;
+        if(lits[0]==falseLit){
+          lits[0]=lits[1];
+          lits[1]=falseLit;
+        }
+        ++i;
+        const Lit first=lits[0];
+        const Watcher w{c,first};
+        if(first!=ws[i-1].blocker && value(first)==True){
+          ws[j++]=w;
+          continue;
+        }
+        //look for a new literal to watch
+        const std::uint32_t size=clauseSize(c);
+        bool found=false;
+        for(std::uint32_t k=2;k<size;++k){
+          if(value(lits[k])!=False){
+            lits[1]=lits[k];
+            lits[k]=falseLit;
+            watches[lits[1]^1].push_back(w);
+            found=true;
+            break;
+          }
+        }
+        if(found){
+          continue;
+        }
+        //the clause is unit or conflicting
+        ws[j++]=w;
+        if(value(first)==False){
+          conflict=c;
+          propagated=trail.size();
+          while(i<ws.size()){
+            ws[j++]=ws[i++];
+          }
+        }else{
+          enqueue(first,c);
+        }
+      }
+      ws.resize(j);
+    }
+    return conflict;
+  }
+
+  /*
+  A literal of the learnt clause is redundant if all the other literals of its reason are in the clause or at level 0
+  */
+  bool CdclSolver::isRedundant(Lit p){
+    const ClauseRef c=reasons[var(p)];
+    if(c==NoClause){
+      return false;
+    }
+    Lit *lits=literals(c);
+    for(std::uint32_t k=1;k<clauseSize(c);++k){
+      if(!seen[var(lits[k])] && levels[var(lits[k])]>0){
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void CdclSolver::analyze(ClauseRef conflict,std::vector<Lit>& learnt,int& backtrackLevel){
+    int pathCount=0;
+    Lit p=0;
+    bool first=true;
+    learnt.clear();
+    //room for the asserting literal
+    learnt.push_back(0);
+    std::size_t index=trail.size();
+    do{
+      if(isLearnt(conflict)){
+        bumpClause(conflict);
+      }
+      Lit *lits=literals(conflict);
+      for(std::uint32_t k=first ? 0 : 1;k<clauseSize(conflict);++k){
+        const Lit q=lits[k];
+        if(!seen[var(q)] && levels[var(q)]>0){
+          bumpVariable(var(q));
+          seen[var(q)]=1;
+          if(levels[var(q)]>=decisionLevel()){
+            pathCount++;
+          }else{
+            learnt.push_back(q);
+          }
+        }
+      }
+      first=false;
+      //next literal of the current level to look at
+      while(!seen[var(trail[--index])]){
+      }
+      p=trail[index];
+      conflict=reasons[var(p)];
+      seen[var(p)]=0;
+      pathCount--;
+    }while(pathCount>0);
+    learnt[0]=p^1;
+
+    //minimization
+    std::vector<Lit> analyzed(learnt.begin()+1,learnt.end());
+    std::size_t write=1;
+    for(std::size_t k=1;k<learnt.size();++k){
+      if(!isRedundant(learnt[k])){
+        learnt[write++]=learnt[k];
+      }
+    }
+    learnt.resize(write);
+    for(Lit q : analyzed){
+      seen[var(q)]=0;
+    }
+
+    //the literal of the highest level after the asserting one is watched
+    backtrackLevel=0;
+    if(learnt.size()>1){
+      std::size_t max=1;
+      for(std::size_t k=2;k<learnt.size();++k){
+        if(levels[var(learnt[k])]>levels[var(learnt[max])]){
+          max=k;
+        }
+      }
+      std::swap(learnt[1],learnt[max]);
+      backtrackLevel=levels[var(learnt[1])];
+    }
+  }
+
+  void CdclSolver::cancelUntil(int level){
+    if(decisionLevel()<=level){
+      return;
+    }
+    for(std::size_t k=trail.size();k>static_cast<std::size_t>(trailLimits[level]);--k){
+      const int v=var(trail[k-1]);
+      assigns[v]=Undef;
+      polarity[v]=sign(trail[k-1]);
+      if(heapIndex[v]<0){
+        heapInsert(v);
+      }
+    }
+    trail.resize(trailLimits[level]);
+    trailLimits.resize(level);
+    propagated=trail.size();
+  }
+
+  CdclSolver::Lit CdclSolver::pickBranchLiteral(){
+    while(!heap.empty()){
+      const int v=heapPop();
+      if(assigns[v]==Undef){
+        return 2*v+polarity[v];
+      }
+    }
+    return NoClause;
+  }
+
+  void CdclSolver::bumpVariable(int v){
+    activity[v]+=variableIncrement;
+    if(activity[v]>1e100){
+      for(double& a : activity){
+        a*=1e-100;
+      }
+      variableIncrement*=1e-100;
+    }
+    if(heapIndex[v]>=0){
+      heapUp(heapIndex[v]);
+    }
+  }
+
+  void CdclSolver::bumpClause(ClauseRef c){
+    clauseActivity(c)+=clauseIncrement;
+    if(clauseActivity(c)>1e20f){
+      for(ClauseRef l : learnts){
+        clauseActivity(l)*=1e-20f;
+      }
+      clauseIncrement*=1e-20f;
+    }
+  }
+
+  /*
+  Remove half of the learnt clauses, the least active ones, except the binary and the locked ones
+  */
+  void CdclSolver::reduceLearnts(){
+    std::sort(learnts.begin(),learnts.end(),[this](ClauseRef a,ClauseRef b){
+      return clauseActivity(a)<clauseActivity(b);
+    });
+    std::size_t write=0;
+    for(std::size_t k=0;k<learnts.size();++k){
+      const ClauseRef c=learnts[k];
+      if(k<learnts.size()/2 && clauseSize(c)>2 && !isLocked(c)){
+        //removed clauses are marked, their watchers are dropped by collectGarbage
+        arena[c+1]=2;
+        wasted+=clauseSize(c)+3;
+      }else{
+        learnts[write++]=c;
+      }
+    }
+    learnts.resize(write);
+    collectGarbage();
+  }
+
+  /*
+  Drop the watchers of removed clauses, and compact the arena when half of it is wasted
+  */
+  void CdclSolver::collectGarbage(){
+    for(std::vector<Watcher>& ws : watches){
+      std::size_t write=0;
+      for(const Watcher& w : ws){
+        if(arena[w.clause+1]!=2){
+          ws[write++]=w;
+        }
+      }
+      ws.resize(write);
+    }
+    if(2*wasted<arena.size()){
+      return;
+    }
+    std::vector<std::uint32_t> compacted;
+    compacted.reserve(arena.size()-wasted);
+    std::vector<ClauseRef> moved(arena.size(),NoClause);
+    for(ClauseRef c=0;c<arena.size();c+=clauseSize(c)+3){
+      if(arena[c+1]!=2){
+        moved[c]=compacted.size();
+        compacted.insert(compacted.end(),arena.begin()+c,arena.begin()+c+clauseSize(c)+3);
+      }
+    }
+    for(std::vector<Watcher>& ws : watches){
+      for(Watcher& w : ws){
+        w.clause=moved[w.clause];
+      }
+    }
+    for(ClauseRef& c : learnts){
+      c=moved[c];
+    }
+    for(Lit p : trail){
+      if(reasons[var(p)]!=NoClause){
+        reasons[var(p)]=moved[reasons[var(p)]];
+      }
+    }
+    arena.swap(compacted);
+    wasted=0;
+  }
+
+  /*
+  Search until a model, a proof of unsatisfiability or the conflict budget is reached.
+  Returns True, False or Undef (restart).
+  */
+  std::int8_t CdclSolver::search(int conflictBudget){
+    std::vector<Lit> learnt;
+    int conflictCount=0;
+    while(true){
+      const ClauseRef conflict=propagate();
+      if(conflict!=NoClause){
+        conflicts++;
+        conflictCount++;
+        if(decisionLevel()==0){
+          ok=false;
+          return False;
+        }
+        int backtrackLevel;
+        analyze(conflict,learnt,backtrackLevel);
+        cancelUntil(backtrackLevel);
+        if(learnt.size()==1){
+          enqueue(learnt[0],NoClause);
+        }else{
+          const ClauseRef c=allocClause(learnt,true);
+          learnts.push_back(c);
+          attachClause(c);
+          bumpClause(c);
+          enqueue(learnt[0],c);
+        }
+        variableIncrement/=0.95;
+        clauseIncrement/=0.999f;
+      }else{
+        if(conflictCount>=conflictBudget){
+          cancelUntil(0);
+          return Undef;
+        }
+        if(learnts.size()>=maxLearnts+trail.size()){
+          reduceLearnts();
+        }
+        Lit next=NoClause;
+        while(decisionLevel()<static_cast<int>(assumptions.size())){
+          const Lit p=assumptions[decisionLevel()];
+          if(value(p)==True){
+            //already true, the level stays empty
+            trailLimits.push_back(trail.size());
+          }else if(value(p)==False){
+            return False;
+          }else{
+            next=p;
+            break;
+          }
+        }
+        if(next==NoClause){
+          next=pickBranchLiteral();
+          if(next==NoClause){
+            return True;
+          }
+        }
+        trailLimits.push_back(trail.size());
+        enqueue(next,NoClause);
+      }
+    }
+  }
+
+  bool CdclSolver::solve(){
+    return solve(std::vector<int>());
+  }
+
+  bool CdclSolver::solve(const std::vector<int>& assumed){
+    model.clear();
+    if(!ok){
+      return false;
+    }
+    cancelUntil(0);
+    assumptions.clear();
+    for(int l : assumed){
+      reserveVariables(std::abs(l));
+      assumptions.push_back(toLit(l));
+    }
+    maxLearnts=std::max<double>(arena.size()/12.0,1000);
+    std::int8_t status=Undef;
+    for(int restart=0;status==Undef;++restart){
+      status=search(static_cast<int>(luby(2,restart)*100));
+      maxLearnts*=1.05;
+    }
+    if(status==True){
+      model.resize(assigns.size());
+      for(std::size_t v=0;v<assigns.size();++v){
+        model[v]=(assigns[v]==True);
+      }
+    }
+    cancelUntil(0);
+    return status==True;
+  }
+
+  bool CdclSolver::modelValue(int variable) const{
+    return variable>=1 && variable<=static_cast<int>(model.size()) && model[variable-1];
+  }
+
+  void CdclSolver::heapInsert(int v){
+    heapIndex[v]=heap.size();
+    heap.push_back(v);
+    heapUp(heap.size()-1);
+  }
+
+  void CdclSolver::heapUp(int i){
+    const int v=heap[i];
+    while(i>0 && heapLess(v,heap[(i-1)/2])){
+      heap[i]=heap[(i-1)/2];
+      heapIndex[heap[i]]=i;
+      i=(i-1)/2;
+    }
+    heap[i]=v;
+    heapIndex[v]=i;
+  }
+
+  void CdclSolver::heapDown(int i){
+    const int v=heap[i];
+    const int size=heap.size();
+    while(2*i+1<size){
+      int child=2*i+1;
+      if(child+1<size && heapLess(heap[child+1],heap[child])){
+        child++;
+      }
+      if(!heapLess(heap[child],v)){
+        break;
+      }
+      heap[i]=heap[child];
+      heapIndex[heap[i]]=i;
+      i=child;
+    }
+    heap[i]=v;
+    heapIndex[v]=i;
+  }
+
+  int CdclSolver::heapPop(){
+    const int v=heap[0];
+    heapIndex[v]=-1;
+    heap[0]=heap.back();
+    heap.pop_back();
+    if(!heap.empty()){
+      heapIndex[heap[0]]=0;
+      heapDown(0);
+    }
+    return v;
+  }
+
+  MinisatProcess::MinisatProcess(const std::string& cnfPath,const std::string& outPath)
+  : cnfPath(cnfPath),outPath(outPath),cnfFile(cnfPath){
+  }
+
+  void MinisatProcess::reserveVariables(int count){
+    cnfFile.reserveVariables(count);
+  }
+
+  void MinisatProcess::addClause(const std::vector<int>& literals){
+    cnfFile.addClause(literals);
+  }
+
+  bool MinisatProcess::solve(){
+    model.clear();
+    if(!cnfFile.close()){
+      return false;
+    }
+    const std::string command="minisat "+cnfPath+" "+outPath+" > /dev/null 2>&1";
+    if(std::system(command.c_str())<0){
+      return false;
+    }
+    return readModel(outPath,model);
+  }
+
+  bool MinisatProcess::readModel(const std::string& outPath,std::vector<bool>& model){
+    model.clear();
+    std::ifstream outFile(outPath.c_str());
+    std::string line;
+    if(!std::getline(outFile,line) || line!="SAT"){
+      return false;
+    }
+    int literal;
+    while(outFile >> literal && literal!=0){
+      const std::size_t v=std::abs(literal);
+      if(model.size()<v){
+        model.resize(v,false);
+      }
+      model[v-1]=(literal>0);
+    }
+    return true;
+  }
+
+  bool MinisatProcess::modelValue(int variable) const{
+    return variable>=1 && variable<=static_cast<int>(model.size()) && model[variable-1];
+  }
+
+}
@@ -0,0 +1,164 @@
+#ifndef SAT_SOLVER_H
+#define SAT_SOLVER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "ClauseSink.h"
+#include "DimacsWriter.h"
+
+namespace fa {
+
+  /**
+   * SAT solver fed clause by clause
+   */
+  class SatSolver : public ClauseSink {
+  public:
+    /**
+     * Tell if the clauses added so far are satisfiable
+     */
+    virtual bool solve()=0;
+
+    /**
+     * Value of the variable in the model found by the last successful solve()
+     */
+    virtual bool modelValue(int variable) const=0;
+  };
+
+  /**
+   * Conflict-driven clause learning solver running in the process.
+   *
+   * Two watched literals, first-UIP learning with clause minimization, VSIDS
+   * decisions with phase saving, Luby restarts and activity-based reduction of
+   * the learnt clauses.
+   */
+  class CdclSolver : public SatSolver {
+  public:
+    CdclSolver();
+
+    void reserveVariables(int count);
+    void addClause(const std::vector<int>& literals);
+    bool solve();
+    bool modelValue(int variable) const;
+
+    /**
+     * Tell if the clauses are satisfiable with the assumptions (literals) true.
+     * The assumptions only hold for this call, the learnt clauses are kept for
+     * the next ones.
+     */
+    bool solve(const std::vector<int>& assumptions);
+
+    std::size_t countVariables() const { return assigns.size(); }
+    std::size_t countConflicts() const { return conflicts; }
+
+  private:
+    //literal of the variable v (0-based): 2*v, its negation 2*v+1
+    typedef std::uint32_t Lit;
+    typedef std::uint32_t ClauseRef;
+    static constexpr ClauseRef NoClause=~ClauseRef(0);
+    //values of the variables
+    static constexpr std::int8_t False=0;
+    static constexpr std::int8_t True=1;
+    static constexpr std::int8_t Undef=2;
+
+    struct Watcher{
+      ClauseRef clause;
+      Lit blocker;
+    };
+
+    static Lit toLit(int literal) { return literal>0 ? 2*(literal-1) : 2*(-literal-1)+1; }
+    static int var(Lit p) { return p>>1; }
+    static bool sign(Lit p) { return p&1; }
+
+    std::int8_t value(Lit p) const{
+      const std::int8_t v=assigns[var(p)];
+      return v==Undef ? Undef : static_cast<std::int8_t>(v^sign(p));
+    }
+
+    //clauses are stored in arena: size, learnt flag, activity, then the literals
+    std::uint32_t clauseSize(ClauseRef c) const { return arena[c]; }
+    bool isLearnt(ClauseRef c) const { return arena[c+1]!=0; }
+    Lit *literals(ClauseRef c) { return &arena[c+3]; }
+    float& clauseActivity(ClauseRef c) { return *reinterpret_cast<float*>(&arena[c+2]); }
+
+    ClauseRef allocClause(const std::vector<Lit>& lits,bool learnt);
+    void attachClause(ClauseRef c);
+    bool isLocked(ClauseRef c);
+    int decisionLevel() const { return trailLimits.size(); }
+    void enqueue(Lit p,ClauseRef from);
+    ClauseRef propagate();
+    void analyze(ClauseRef conflict,std::vector<Lit>& learnt,int& backtrackLevel);
+    bool isRedundant(Lit p);
+    void cancelUntil(int level);
+    Lit pickBranchLiteral();
+    void bumpVariable(int v);
+    void bumpClause(ClauseRef c);
+    void reduceLearnts();
+    void collectGarbage();
+    std::int8_t search(int conflictBudget);
+
+    //binary heap of the unassigned variables, ordered by activity
+    bool heapLess(int a,int b) const { return activity[a]>activity[b]; }
+    void heapInsert(int v);
+    void heapUp(int i);
+    void heapDown(int i);
+    int heapPop();
+
+    bool ok;
+    std::vector<std::uint32_t> arena;
+    std::size_t wasted;
+    std::vector<ClauseRef> learnts;
+    std::vector<std::vector<Watcher>> watches;
+    std::vector<std::int8_t> assigns;
+    std::vector<bool> polarity;
+    std::vector<int> levels;
+    std::vector<ClauseRef> reasons;
+    std::vector<Lit> trail;
+    std::vector<int> trailLimits;
+    //decided first, one per decision level
+    std::vector<Lit> assumptions;
+    std::size_t propagated;
+    std::vector<double> activity;
+    double variableIncrement;
+    float clauseIncrement;
+    std::vector<int> heap;
+    //position of each variable in heap, -1 if absent
+    std::vector<int> heapIndex;
+    std::vector<char> seen;
+    std::vector<bool> model;
+    double maxLearnts;
+    std::size_t conflicts;
+  };
+
+  /**
+   * External minisat run as a separate process.
+   *
+   * The clauses are written in DIMACS to cnfPath as they are added. solve() runs
+   * "minisat cnfPath outPath" and reads the model back from outPath.
+   */
+  class MinisatProcess : public SatSolver {
+  public:
+    MinisatProcess(const std::string& cnfPath,const std::string& outPath);
+
+    void reserveVariables(int count);
+    void addClause(const std::vector<int>& literals);
+    bool solve();
+    bool modelValue(int variable) const;
+
+    /**
+     * Read a minisat result file: tell if it says SAT, and put the value of the
+     * variable v in model[v-1]
+     */
+    static bool readModel(const std::string& outPath,std::vector<bool>& model);
+
+  private:
+    std::string cnfPath;
+    std::string outPath;
+    DimacsWriter cnfFile;
+    std::vector<bool> model;
+  };
+
+}
+
+#endif // SAT_SOLVER_H
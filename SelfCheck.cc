@@ -0,0 +1,510 @@
+#include "AutomatonFile.h"
+#include "Cardinality.h"
+#include "CompiledDfa.h"
+#include "FrozenAutomaton.h"
+#include "Inclusion.h"
+#include "InclusionEncoder.h"
+#include "Matcher.h"
+#include "SatSolver.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+Self-check of the engines: each one is compared with a brute force answer on
+small random automata and formulas. Built by make.sh, run with ./SelfCheck
+(an optional argument gives the seed). Exits with 1 if a check fails.
+*/
+
+using namespace fa;
+
+static int checks=0;
+static int failures=0;
+
+static void check(bool condition,const std::string& what){
+  ++checks;
+  if(!condition){
+    if(failures<20){
+      std::cerr << "FAILED: " << what << "\n";
+    }
+    ++failures;
+  }
+}
+
+static int randomInt(int bound){
+  return rand()%bound;
+}
+
+/*
+Random automaton with n states (named 3i+1, to be distinct from their indices) over the symbols
+*/
+static FrozenAutomaton randomAutomaton(int n,const std::string& symbols){
+  std::vector<int> names(n);
+  std::vector<unsigned char> flags(n);
+  std::vector<FrozenAutomaton::Edge> edges;
+  for(int s=0;s<n;++s){
+    names[s]=3*s+1;
+    flags[s]=(randomInt(5)==0 ? FrozenAutomaton::Initial : 0) | (randomInt(3)==0 ? FrozenAutomaton::Final : 0);
+    for(std::size_t a=0;a<symbols.size();++a){
+      for(int count=randomInt(3);count>0;--count){
+        edges.push_back(FrozenAutomaton::Edge{s,static_cast<int>(a),randomInt(n)});
+      }
+    }
+  }
+  //most of the automata have an initial state
+  if(n>0 && randomInt(10)!=0){
+    flags[0]|=FrozenAutomaton::Initial;
+  }
+  return FrozenAutomaton(std::vector<char>(symbols.begin(),symbols.end()),names,flags,edges);
+}
+
+static std::string randomAlphabet(){
+  static const char *alphabets[]={"ab","abc","bc","a"};
+  return alphabets[randomInt(4)];
+}
+
+/*
+States reached by the word, on sets of indices
+*/
+static std::set<int> run(const FrozenAutomaton& automaton,const std::string& word){
+  std::set<int> current;
+  for(std::size_t s=0;s<automaton.countStates();++s){
+    if(automaton.isInitial(s)){
+      current.insert(s);
+    }
+  }
+  for(char c : word){
+    const int symbol=automaton.symbolIndex(c);
+    std::set<int> next;
+    for(int s : current){
+      if(symbol>=0){
+        for(int to : automaton.successors(s,symbol)){
+          next.insert(to);
+        }
+      }
+    }
+    current.swap(next);
+  }
+  return current;
+}
+
+static bool accepts(const FrozenAutomaton& automaton,const std::string& word){
+  for(int s : run(automaton,word)){
+    if(automaton.isFinal(s)){
+      return true;
+    }
+  }
+  return false;
+}
+
+/*
+Every word over the symbols of length at most maxLength, shortest first
+*/
+static std::vector<std::string> allWords(const std::vector<char>& symbols,int maxLength){
+  std::vector<std::string> words(1,"");
+  for(std::size_t first=0;first<words.size();++first){
+    if(static_cast<int>(words[first].size())<maxLength){
+      for(char c : symbols){
+        words.push_back(words[first]+c);
+      }
+    }
+  }
+  return words;
+}
+
+/*
+Length of a shortest word of L(lhs)\L(rhs), -1 if there is none: breadth-first
+search on the pairs of sets of states
+*/
+static int shortestCounterexample(const FrozenAutomaton& lhs,const FrozenAutomaton& rhs){
+  typedef std::pair<std::set<int>,std::set<int>> Pair;
+  std::map<Pair,int> lengths;
+  std::deque<Pair> queue;
+  const Pair start(run(lhs,""),run(rhs,""));
+  lengths[start]=0;
+  queue.push_back(start);
+  while(!queue.empty()){
+    const Pair current=queue.front();
+    queue.pop_front();
+    bool lhsFinal=false;
+    bool rhsFinal=false;
+    for(int s : current.first){
+      lhsFinal|=lhs.isFinal(s);
+    }
+    for(int s : current.second){
+      rhsFinal|=rhs.isFinal(s);
+    }
+    if(lhsFinal && !rhsFinal){
+      return lengths[current];
+    }
+    for(std::size_t a=0;a<lhs.countSymbols();++a){
+      const int other=rhs.symbolIndex(lhs.symbol(a));
+      Pair next;
+      for(int s : current.first){
+        for(int to : lhs.successors(s,a)){
+          next.first.insert(to);
+        }
+      }
+      for(int s : current.second){
+        if(other>=0){
+          for(int to : rhs.successors(s,other)){
+            next.second.insert(to);
+          }
+        }
+      }
+      if(!next.first.empty() && lengths.find(next)==lengths.end()){
+        lengths[next]=lengths[current]+1;
+        queue.push_back(next);
+      }
+    }
+  }
+  return -1;
+}
+
+/*
+CDCL solver against the enumeration of the assignments, with and without assumptions
+*/
+static void checkSolver(){
+  for(int trial=0;trial<300;++trial){
+    const int variables=1+randomInt(10);
+    std::vector<std::vector<int>> clauses(1+randomInt(5*variables));
+    CdclSolver solver;
+    solver.reserveVariables(variables);
+    for(std::vector<int>& clause : clauses){
+      for(int size=1+randomInt(3);size>0;--size){
+        const int v=1+randomInt(variables);
+        clause.push_back(randomInt(2) ? v : -v);
+      }
+      solver.addClause(clause);
+    }
+    std::vector<int> assumptions;
+    for(int count=randomInt(3);count>0;--count){
+      const int v=1+randomInt(variables);
+      assumptions.push_back(randomInt(2) ? v : -v);
+    }
+    for(int withAssumptions=0;withAssumptions<2;++withAssumptions){
+      const std::vector<int> assumed=withAssumptions ? assumptions : std::vector<int>();
+      bool satisfiable=false;
+      for(unsigned model=0;model<(1u<<variables) && !satisfiable;++model){
+        std::vector<std::vector<int>> all=clauses;
+        for(int literal : assumed){
+          all.push_back(std::vector<int>(1,literal));
+        }
+        satisfiable=true;
+        for(std::size_t c=0;c<all.size() && satisfiable;++c){
+          bool satisfied=false;
+          for(int literal : all[c]){
+            satisfied|=((model>>(std::abs(literal)-1))&1)==(literal>0);
+          }
+          satisfiable=satisfied;
+        }
+      }
+      const bool solved=withAssumptions ? solver.solve(assumed) : solver.solve();
+      check(solved==satisfiable,"CdclSolver answer, trial "+std::to_string(trial));
+      if(solved){
+        bool model=true;
+        for(const std::vector<int>& clause : clauses){
+          bool satisfied=false;
+          for(int literal : clause){
+            satisfied|=solver.modelValue(std::abs(literal))==(literal>0);
+          }
+          model&=satisfied;
+        }
+        for(int literal : assumed){
+          model&=solver.modelValue(std::abs(literal))==(literal>0);
+        }
+        check(model,"CdclSolver model, trial "+std::to_string(trial));
+      }
+    }
+  }
+}
+
+static const AmoEncoding amoEncodings[]={AmoEncoding::Pairwise,AmoEncoding::Sequential,AmoEncoding::Commander,
+                                         AmoEncoding::Product,AmoEncoding::Binary,AmoEncoding::Bimander};
+
+/*
+At most one and exactly one, under every assignment of the literals
+*/
+static void checkCardinality(){
+  for(AmoEncoding encoding : amoEncodings){
+    for(int n=1;n<=9;++n){
+      std::vector<int> literals(n);
+      for(int i=0;i<n;++i){
+        literals[i]=i+1;
+      }
+      CdclSolver atMostOne;
+      CdclSolver exactlyOne;
+      atMostOne.reserveVariables(n+countAmoVariables(n,encoding));
+      exactlyOne.reserveVariables(n+countAmoVariables(n,encoding));
+      addAtMostOne(atMostOne,literals,encoding,n+1);
+      addExactlyOne(exactlyOne,literals,encoding,n+1);
+      for(unsigned values=0;values<(1u<<n);++values){
+        std::vector<int> assumptions(n);
+        for(int i=0;i<n;++i){
+          assumptions[i]=(values>>i)&1 ? i+1 : -(i+1);
+        }
+        const int count=__builtin_popcount(values);
+        const std::string what=" with "+std::to_string(n)+" literals, encoding "+std::to_string(static_cast<int>(encoding));
+        check(atMostOne.solve(assumptions)==(count<=1),"addAtMostOne"+what);
+        check(exactlyOne.solve(assumptions)==(count==1),"addExactlyOne"+what);
+      }
+    }
+  }
+}
+
+/*
+SAT encoding of the counterexamples of a given length, for every AMO and letter encoding
+*/
+static void checkEncoder(){
+  const LetterEncoding letterEncodings[]={LetterEncoding::OneHot,LetterEncoding::Logarithmic};
+  for(AmoEncoding encoding : amoEncodings){
+    for(LetterEncoding letters : letterEncodings){
+      for(int trial=0;trial<12;++trial){
+        const FrozenAutomaton lhs=randomAutomaton(1+randomInt(4),randomAlphabet());
+        const FrozenAutomaton rhs=randomAutomaton(1+randomInt(4),randomAlphabet());
+        for(int length=0;length<=4;++length){
+          InclusionEncoder encoder(lhs,rhs,length,encoding,letters);
+          if(trial%2){
+            encoder.trim();
+          }
+          CdclSolver solver;
+          encoder.encode(solver);
+          bool exists=false;
+          for(const std::string& word : allWords(encoder.alphabet(),length)){
+            exists|=static_cast<int>(word.size())==length && accepts(lhs,word) && !accepts(rhs,word);
+          }
+          const std::string what=", length "+std::to_string(length)+", trial "+std::to_string(trial);
+          const bool solved=solver.solve();
+          check(solved==exists,"InclusionEncoder answer"+what);
+          if(solved){
+            const std::string word=encoder.decodeWord(solver,length);
+            check(static_cast<int>(word.size())==length && accepts(lhs,word) && !accepts(rhs,word),"InclusionEncoder word"+what);
+          }
+        }
+      }
+    }
+  }
+}
+
+/*
+The three inclusion engines, the witness and HKC equivalence
+*/
+static void checkInclusion(){
+  for(int trial=0;trial<400;++trial){
+    const FrozenAutomaton lhs=randomAutomaton(randomInt(6),randomAlphabet());
+    const FrozenAutomaton rhs=randomAutomaton(randomInt(6),randomAlphabet());
+    const int shortest=shortestCounterexample(lhs,rhs);
+    const bool included=shortest<0;
+    const std::string what=", trial "+std::to_string(trial);
+    check(isIncludedComplement(lhs,rhs)==included,"isIncludedComplement"+what);
+    check(isIncludedAntichain(lhs,rhs)==included,"isIncludedAntichain"+what);
+    check(isIncludedHkc(lhs,rhs)==included,"isIncludedHkc"+what);
+    std::string word;
+    check(findCounterexample(lhs,rhs,word)==!included,"findCounterexample answer"+what);
+    if(!included){
+      check(static_cast<int>(word.size())==shortest && accepts(lhs,word) && !accepts(rhs,word),"findCounterexample word"+what);
+    }
+    const bool equivalent=included && shortestCounterexample(rhs,lhs)<0;
+    check(isEquivalentHkc(lhs,rhs)==equivalent,"isEquivalentHkc"+what);
+  }
+}
+
+/*
+Every pair of states of the DFA is told apart by a word (table filling)
+*/
+static bool isMinimal(const FrozenAutomaton& dfa){
+  const int n=dfa.countStates();
+  std::vector<char> distinct(n*n,0);
+  for(int p=0;p<n;++p){
+    for(int q=0;q<n;++q){
+      distinct[p*n+q]=dfa.isFinal(p)!=dfa.isFinal(q);
+    }
+  }
+  for(bool changed=true;changed;){
+    changed=false;
+    for(int p=0;p<n;++p){
+      for(int q=0;q<n;++q){
+        for(std::size_t a=0;a<dfa.countSymbols() && !distinct[p*n+q];++a){
+          if(distinct[*dfa.successors(p,a).begin()*n+*dfa.successors(q,a).begin()]){
+            distinct[p*n+q]=1;
+            changed=true;
+          }
+        }
+      }
+    }
+  }
+  for(int p=0;p<n;++p){
+    for(int q=p+1;q<n;++q){
+      if(!distinct[p*n+q]){
+        return false;
+      }
+    }
+  }
+  return dfa.accessibleStates().count()==static_cast<std::size_t>(n);
+}
+
+/*
+Minimization and the other constructions keeping the language
+*/
+static void checkMinimization(){
+  for(int trial=0;trial<300;++trial){
+    const FrozenAutomaton automaton=randomAutomaton(randomInt(7),randomAlphabet());
+    const std::vector<std::string> words=allWords(automaton.alphabet(),6);
+    const FrozenAutomaton minimal[3]={automaton.createMinimalHopcroft(),automaton.createMinimalMoore(),automaton.createMinimalBrzozowski()};
+    const FrozenAutomaton others[3]={automaton.createDeterministic(),automaton.createBisimulationQuotient(),automaton.createSimulationPruned()};
+    const std::string what=", trial "+std::to_string(trial);
+    for(int i=0;i<3;++i){
+      const std::string algorithm=std::to_string(i)+what;
+      check(minimal[i].isDeterministic() && minimal[i].isComplete(),"minimal automaton not a complete DFA "+algorithm);
+      if(!minimal[i].isDeterministic() || !minimal[i].isComplete()){
+        continue;
+      }
+      check(isMinimal(minimal[i]),"minimal automaton with equivalent states "+algorithm);
+      check(minimal[i].countStates()==minimal[0].countStates(),"minimal automata of different sizes "+algorithm);
+      for(const std::string& word : words){
+        check(accepts(minimal[i],word)==accepts(automaton,word),"minimal automaton language "+algorithm);
+        check(accepts(others[i],word)==accepts(automaton,word),"determinization or reduction language "+algorithm);
+      }
+    }
+    check(others[0].isDeterministic() || others[0].countStates()==0,"createDeterministic"+what);
+  }
+}
+
+/*
+Word classification: readString, the matcher (table, lazy DFA, flushed lazy DFA, batch) and the compiled DFA
+*/
+static void checkMatching(){
+  for(int trial=0;trial<150;++trial){
+    const int n=trial%10==0 ? 60+randomInt(20) : randomInt(9);
+    const FrozenAutomaton automaton=randomAutomaton(n,randomAlphabet());
+    const FrozenAutomaton deterministic=automaton.createMinimalHopcroft();
+    std::vector<std::string> words;
+    for(int count=0;count<200;++count){
+      std::string word;
+      for(int length=randomInt(14);length>0;--length){
+        word+="abcz"[randomInt(4)];
+      }
+      words.push_back(word);
+    }
+    const std::vector<std::string_view> views(words.begin(),words.end());
+    const Matcher matchers[3]={Matcher(automaton),Matcher(automaton,64),Matcher(deterministic)};
+    const CompiledDfa compiled(automaton);
+    Bitset batches[3];
+    for(int m=0;m<3;++m){
+      batches[m]=matchers[m].matchBatch(views);
+    }
+    const std::vector<std::uint32_t> states=compiled.runInterleaved(views);
+    const std::string what=", trial "+std::to_string(trial);
+    for(std::size_t w=0;w<words.size();++w){
+      const std::set<int> reached=run(automaton,words[w]);
+      const Bitset bits=automaton.readString(words[w]);
+      check(bits.count()==reached.size() && std::all_of(reached.begin(),reached.end(),[&bits](int s){ return bits.test(s); }),"readString"+what);
+      const bool accepted=accepts(automaton,words[w]);
+      for(int m=0;m<3;++m){
+        check(matchers[m].match(words[w])==accepted,"Matcher::match "+std::to_string(m)+what);
+        check(batches[m].test(w)==accepted,"Matcher::matchBatch "+std::to_string(m)+what);
+      }
+      check(compiled.match(words[w].data(),words[w].size())==accepted,"CompiledDfa::match"+what);
+      check(compiled.isAccepting(states[w])==accepted,"CompiledDfa::runInterleaved"+what);
+    }
+  }
+}
+
+static bool sameAutomaton(const FrozenAutomaton& lhs,const FrozenAutomaton& rhs){
+  if(lhs.alphabet()!=rhs.alphabet() || lhs.countStates()!=rhs.countStates() || lhs.countTransitions()!=rhs.countTransitions()){
+    return false;
+  }
+  for(std::size_t s=0;s<lhs.countStates();++s){
+    if(lhs.stateName(s)!=rhs.stateName(s) || lhs.isInitial(s)!=rhs.isInitial(s) || lhs.isFinal(s)!=rhs.isFinal(s)){
+      return false;
+    }
+    for(std::size_t a=0;a<lhs.countSymbols();++a){
+      const FrozenAutomaton::StateRange l=lhs.successors(s,a);
+      const FrozenAutomaton::StateRange r=rhs.successors(s,a);
+      if(!std::equal(l.begin(),l.end(),r.begin(),r.end())){
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/*
+Write the bytes as the file and tell if loadAutomaton accepts it
+*/
+static bool loads(const std::string& path,const std::string& bytes){
+  std::ofstream(path,std::ios::binary).write(bytes.data(),bytes.size());
+  FrozenAutomaton automaton;
+  return loadAutomaton(path,automaton);
+}
+
+/*
+Binary format: round trip, and files cut or with corrupted sections
+*/
+static void checkFile(){
+  const std::string path="SelfCheck.fa";
+  for(int trial=0;trial<50;++trial){
+    const FrozenAutomaton automaton=randomAutomaton(randomInt(30),randomAlphabet());
+    FrozenAutomaton loaded;
+    check(saveAutomaton(automaton,path) && loadAutomaton(path,loaded) && sameAutomaton(automaton,loaded),"save and load, trial "+std::to_string(trial));
+  }
+  FrozenAutomaton automaton=randomAutomaton(20,"ab");
+  while(automaton.countTransitions()==0){
+    automaton=randomAutomaton(20,"ab");
+  }
+  saveAutomaton(automaton,path);
+  std::string bytes;
+  {
+    std::ifstream in(path,std::ios::binary);
+    bytes.assign(std::istreambuf_iterator<char>(in),std::istreambuf_iterator<char>());
+  }
+  AutomatonFileHeader header;
+  std::memcpy(&header,bytes.data(),sizeof(header));
+  check(loads(path,bytes),"load of a valid file");
+  check(!loads(path,bytes.substr(0,bytes.size()-1)),"load of a cut file");
+  check(!loads(path,bytes.substr(0,sizeof(header)/2)),"load of a cut header");
+  std::string corrupted=bytes;
+  corrupted[0]='X';
+  check(!loads(path,corrupted),"load with a wrong magic");
+  const int outside=header.countStates;
+  corrupted=bytes;
+  std::memcpy(&corrupted[header.targetsPosition],&outside,sizeof(outside));
+  check(!loads(path,corrupted),"load with a target out of the states");
+  corrupted=bytes;
+  std::memcpy(&corrupted[header.namesPosition+sizeof(int)],&corrupted[header.namesPosition],sizeof(int));
+  check(!loads(path,corrupted),"load with names not increasing");
+  const std::uint32_t last=header.countTransitions;
+  corrupted=bytes;
+  const std::uint32_t zero=0;
+  std::memcpy(&corrupted[header.offsetsPosition+sizeof(last)],&last,sizeof(last));
+  std::memcpy(&corrupted[header.offsetsPosition+2*sizeof(last)],&zero,sizeof(zero));
+  check(!loads(path,corrupted),"load with decreasing offsets");
+  std::remove(path.c_str());
+}
+
+int main(int argc,char **argv){
+  srand(argc>1 ? atoi(argv[1]) : 1);
+  checkSolver();
+  checkCardinality();
+  checkEncoder();
+  checkInclusion();
+  checkMinimization();
+  checkMatching();
+  checkFile();
+  if(failures!=0){
+    std::cerr << failures << " of " << checks << " checks failed\n";
+    return 1;
+  }
+  std::cout << checks << " checks passed\n";
+  return 0;
+}
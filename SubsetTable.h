@@ -0,0 +1,122 @@
+#ifndef SUBSET_TABLE_H
+#define SUBSET_TABLE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace fa {
+
+  /**
+   * Interned sets of states, numbered 0,1,2... in insertion order.
+   *
+   * A set is given as a sequence of Element (sorted state indices, or the words
+   * of a bitset). All the sequences are stored one after the other in a single
+   * arena, and found again through an open-addressing hash table.
+   */
+  template<class Element>
+  class SubsetTable {
+  public:
+    SubsetTable() : slots(16,-1) {}
+
+    std::size_t size() const { return hashes.size(); }
+
+    const Element *begin(int id) const { return arena.data()+offsets[id]; }
+    const Element *end(int id) const { return arena.data()+offsets[id+1]; }
+
+    /**
+     * Id of the subset, -1 if the subset was never inserted
+     */
+    int find(const Element *first,const Element *last) const{
+      const std::uint64_t h=hash(first,last);
+      for(std::size_t i=h&(slots.size()-1);slots[i]>=0;i=(i+1)&(slots.size()-1)){
+        if(hashes[slots[i]]==h && equals(slots[i],first,last)){
+          return slots[i];
+        }
+      }
+      return -1;
+    }
+
+    /**
+     * Id of the subset, inserted if it was not already present.
+     * The second member tells if the subset was inserted.
+     */
+    std::pair<int,bool> insert(const Element *first,const Element *last){
+      const std::uint64_t h=hash(first,last);
+      std::size_t i=h&(slots.size()-1);
+      for(;slots[i]>=0;i=(i+1)&(slots.size()-1)){
+        if(hashes[slots[i]]==h && equals(slots[i],first,last)){
+          return std::pair<int,bool>(slots[i],false);
+        }
+      }
+      const int id=hashes.size();
+      if(offsets.empty()){
+        offsets.push_back(0);
+      }
+      arena.insert(arena.end(),first,last);
+      offsets.push_back(arena.size());
+      hashes.push_back(h);
+      slots[i]=id;
+      //keep the load factor under 1/2
+      if(2*hashes.size()>slots.size()){
+        grow();
+      }
+      return std::pair<int,bool>(id,true);
+    }
+
+    /**
+     * Remove every subset
+     */
+    void clear(){
+      arena.clear();
+      offsets.clear();
+      hashes.clear();
+      std::fill(slots.begin(),slots.end(),-1);
+    }
+
+    /**
+     * Memory used by the table, in bytes
+     */
+    std::size_t memoryUsage() const{
+      return arena.capacity()*sizeof(Element)+offsets.capacity()*sizeof(std::size_t)
+        +hashes.capacity()*sizeof(std::uint64_t)+slots.capacity()*sizeof(int);
+    }
+
+  private:
+    static std::uint64_t hash(const Element *first,const Element *last){
+      std::uint64_t h=0x9e3779b97f4a7c15ULL;
+      for(;first!=last;++first){
+        h^=static_cast<std::uint64_t>(*first)+0x9e3779b97f4a7c15ULL+(h<<6)+(h>>2);
+        h*=0xff51afd7ed558ccdULL;
+      }
+      return h^(h>>33);
+    }
+
+    bool equals(int id,const Element *first,const Element *last) const{
+      return static_cast<std::size_t>(last-first)==offsets[id+1]-offsets[id] && std::equal(first,last,begin(id));
+    }
+
+    void grow(){
+      std::vector<int> bigger(2*slots.size(),-1);
+      for(std::size_t id=0;id<hashes.size();++id){
+        std::size_t i=hashes[id]&(bigger.size()-1);
+        while(bigger[i]>=0){
+          i=(i+1)&(bigger.size()-1);
+        }
+        bigger[i]=id;
+      }
+      slots.swap(bigger);
+    }
+
+    std::vector<Element> arena;
+    std::vector<std::size_t> offsets;
+    std::vector<std::uint64_t> hashes;
+    //ids of the subsets, -1 for an empty slot
+    std::vector<int> slots;
+  };
+
+}
+
+#endif // SUBSET_TABLE_H
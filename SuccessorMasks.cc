@@ -0,0 +1,47 @@
+#include "SuccessorMasks.h"
+#include <algorithm>
+#include <utility>
+
+namespace fa {
+
+  SuccessorMasks::SuccessorMasks(const FrozenAutomaton& automaton)
+  : frozen(&automaton),nwords(Bitset(automaton.countStates()).countWords()){
+    masks.assign(automaton.countSymbols()*automaton.countStates()*nwords,0);
+    for(std::size_t a=0;a<automaton.countSymbols();++a){
+      for(std::size_t s=0;s<automaton.countStates();++s){
+        Bitset::Word *m=masks.data()+(a*automaton.countStates()+s)*nwords;
+        for(int to : automaton.successors(s,a)){
+          m[to/Bitset::WordBits]|=Bitset::Word(1)<<(to%Bitset::WordBits);
+        }
+      }
+    }
+  }
+
+  void SuccessorMasks::step(const Bitset& current,int symbol,Bitset& next) const{
+    step(current.data(),symbol,next.data());
+  }
+
+  void SuccessorMasks::step(const Bitset::Word *current,int symbol,Bitset::Word *next) const{
+    std::fill(next,next+nwords,0);
+    for(std::size_t w=0;w<nwords;++w){
+      for(Bitset::Word bits=current[w];bits!=0;bits&=bits-1){
+        detail::orWords(next,mask(w*Bitset::WordBits+__builtin_ctzll(bits),symbol),nwords);
+      }
+    }
+  }
+
+  Bitset SuccessorMasks::readString(const std::string& word) const{
+    Bitset current=frozen->initialStateSet();
+    Bitset next(frozen->countStates());
+    for(char c : word){
+      const int symbol=frozen->symbolIndex(c);
+      if(symbol<0){
+        return Bitset(frozen->countStates());
+      }
+      step(current,symbol,next);
+      std::swap(current,next);
+    }
+    return current;
+  }
+
+}
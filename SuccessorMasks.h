@@ -0,0 +1,61 @@
+#ifndef SUCCESSOR_MASKS_H
+#define SUCCESSOR_MASKS_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "Bitset.h"
+#include "FrozenAutomaton.h"
+
+namespace fa {
+
+  /**
+   * Successors of every (state,symbol) of a frozen automaton, as bitsets.
+   *
+   * One step of the subset simulation is the union of the masks of the active
+   * states. The table takes countStates()^2*countSymbols() bits, so it is meant
+   * for automata of at most MaxStates states.
+   */
+  class SuccessorMasks {
+  public:
+    static constexpr std::size_t MaxStates=4096;
+
+    explicit SuccessorMasks(const FrozenAutomaton& automaton);
+
+    const FrozenAutomaton& automaton() const { return *frozen; }
+
+    /**
+     * Number of words of a state set
+     */
+    std::size_t countWords() const { return nwords; }
+
+    const Bitset::Word *mask(int state,int symbol) const{
+      return masks.data()+(static_cast<std::size_t>(symbol)*frozen->countStates()+state)*nwords;
+    }
+
+    /**
+     * next = states reached from current with the symbol
+     */
+    void step(const Bitset& current,int symbol,Bitset& next) const;
+
+    /**
+     * Same on raw sets of countWords() words
+     */
+    void step(const Bitset::Word *current,int symbol,Bitset::Word *next) const;
+
+    /**
+     * States reached from the initial states by reading word.
+     * The set is empty if a letter is not in the alphabet.
+     */
+    Bitset readString(const std::string& word) const;
+
+  private:
+    const FrozenAutomaton *frozen;
+    std::size_t nwords;
+    //masks of the symbol 0 for every state, then of the symbol 1...
+    std::vector<Bitset::Word> masks;
+  };
+
+}
+
+#endif // SUCCESSOR_MASKS_H
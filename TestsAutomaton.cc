@@ -1,8 +1,10 @@
 #include "Automaton2.h"
+#include "AutomatonFile.h"
+#include "Matcher.h"
 #include <iostream>
 #include <fstream>
 #include <string>
-/*********  main start at line 1020  ************************/
+/*********  main is at the end of the file  ************************/
 namespace fa {
   
   Automaton::Automaton() {
@@ -31,6 +33,7 @@ namespace fa {
     }
     alphabet.push_back(symbol);
     std::sort(alphabet.begin(),alphabet.end(),[](const char& a,const char& b){return a<b;});
+    changed();
     return (hasSymbol(symbol));
   }
   /**
@@ -45,6 +48,7 @@ namespace fa {
     if(!hasSymbol(symbol)){
       return false;
     }
+    changed();
     size_t size=alphabet.size();
     for(size_t i=0;i<size;++i){
       if(alphabet[i]==symbol){
@@ -97,6 +101,7 @@ namespace fa {
       return false;
     }
     states.insert(state);
+    changed();
     return (hasState(state));
   }
   /**
@@ -110,7 +115,7 @@ namespace fa {
     if(!hasState(state)){
       return false;
     }
-    
+    changed();
     for(auto s=states.begin();s!=states.end();){
       if(s->nb==state){
         s=states.erase(s);
@@ -151,6 +156,7 @@ namespace fa {
       for(auto &s : states){
         if(s.nb==state){
           s.isInit=true;
+          changed();
             break;
         }
       }
@@ -174,6 +180,7 @@ namespace fa {
       for(auto &s : states){
         if(s.nb==state){
           s.isFinal=true;
+          changed();
           break;
         }
       }
@@ -211,6 +218,7 @@ namespace fa {
       for(auto &s : states){
         if(s.nb==from){
           s.transitions.insert(Transition(from,alpha,to));
+          changed();
           break;         
         }
       }
@@ -235,6 +243,7 @@ namespace fa {
           for(auto tr : s.transitions){
             if(tr.from==from && tr.symbol==alpha && tr.to==to){ 
               s.transitions.erase(tr);
+              changed();
               
               return (!hasTransition(from,alpha,to));
             }
@@ -520,84 +529,85 @@ namespace fa {
     }
 
     /**
-     * Browse the automaton to check if the language is empty
-     * Or check if a state can join a final state
+     * Run the traversal over the ranks of the states, along the transitions or backward
      */
-    bool Automaton::DepthSearchEmpty(std::_Rb_tree_const_iterator<fa::Automaton::State>& s,std::set<int>& visit)const{
-      visit.insert(s->nb);
-      auto tr=s->transitions.begin();
-      while(tr!=s->transitions.end()){
-        if(tr->to==tr->from){ //if the transition is in the current state, we have already tested if the state was final.
-          tr++;
-          if(tr==s->transitions.end()){
-            break;
+    int Automaton::search(Traversal& traversal,bool backward,const Bitset *targets) const{
+      std::vector<int> names;
+      names.reserve(states.size());
+      for(const State& s : states){
+        names.push_back(s.nb);
+      }
+      //transitions as ranks, from their source or from their target
+      std::vector<std::vector<int>> next(states.size());
+      int from=0;
+      for(const State& s : states){
+        for(const Transition& tr : s.transitions){
+          std::vector<int>::const_iterator to=std::lower_bound(names.begin(),names.end(),tr.to);
+          if(to==names.end() || *to!=tr.to){
+            continue;
           }
-        }
-        auto si = states.find(tr->to);
-        if(si->isFinal){
-          return false;
-        }
-        if(visit.find(si->nb)==visit.end()){
-          if(DepthSearchEmpty(si,visit)==false){
-            return false;
+          if(backward){
+            next[to-names.begin()].push_back(from);
+          }else{
+            next[from].push_back(to-names.begin());
           }
         }
-        tr++;
+        from++;
       }
-      return true;
+      return traversal.run([&next](int s,const auto& add){
+        for(int to : next[s]){
+          add(to);
+        }
+      },[targets](int s){
+        return targets!=nullptr && targets->test(s);
+      });
     }
 
     /**
-     * Check if the language of the automaton is empty
+     * Remove the states whose rank is not in keep, with their transitions
      */
-    bool Automaton::isLanguageEmpty() const{ 
-      if(!isValid()){
-        if(states.empty()){
-          return true;
+    void Automaton::removeStatesOutside(const Bitset& keep){
+      std::set<int> removed;
+      int rank=0;
+      for(auto s=states.begin();s!=states.end();rank++){
+        if(!keep.test(rank)){
+          removed.insert(s->nb);
+          s=states.erase(s);
         }else{
-          for(auto s : states){
-            if (s.isInit && s.isFinal){
-              return false;
-            }
-          }
+          s++;
         }
-        return true;
       }
-      std::set<int> visit;
-      auto s=states.begin();
-      while(s!=states.end()){
-        if(s->isInit){
-          if(s->isFinal){
-            return false;
-          }
-          if(DepthSearchEmpty(s,visit)==false){
-            return false;
+      //the kept states can have transitions to the removed ones
+      for(const State& s : states){
+        for(auto tr=s.transitions.begin();tr!=s.transitions.end();){
+          if(removed.find(tr->to)!=removed.end()){
+            tr=s.transitions.erase(tr);
+          }else{
+            tr++;
           }
         }
-        s++;
       }
-      return true;
+      changed();
     }
 
     /**
-     * Browse the automaton to remove the Non-accessbile states
+     * Check if the language of the automaton is empty
      */
-    void Automaton::DepthSearchRemove(std::_Rb_tree_const_iterator<fa::Automaton::State>& s,std::set<int>& visit){
-      visit.insert(s->nb);
-      auto tr=s->transitions.begin();
-      while(tr!=s->transitions.end()){
-        if(tr->to==tr->from){ //if the transition is in the current state, we have already tested if the state was final.
-          tr++;
-          if(tr==s->transitions.end()){
-            break;
-          }
+    bool Automaton::isLanguageEmpty() const{
+      //search from the initial states, stopped at the first final state
+      Traversal traversal(states.size());
+      Bitset finals(states.size());
+      int rank=0;
+      for(const State& s : states){
+        if(s.isInit){
+          traversal.addSource(rank);
         }
-        auto si = states.find(tr->to);
-        if(visit.find(si->nb)==visit.end()){
-          DepthSearchRemove(si,visit);
+        if(s.isFinal){
+          finals.set(rank);
         }
-        tr++;
+        rank++;
       }
+      return search(traversal,false,&finals)<0;
     }
 
     /**
@@ -607,26 +617,16 @@ namespace fa {
       if(!isValid()){
         return;
       }
-      std::set<int> visit;
-      auto s=states.begin();
-      while(s!=states.end()){
-        if(s->isInit){
-          DepthSearchRemove(s,visit);
-        }
-        s++;
-      }
-      s=states.begin();
-      while(s!=states.end()){
-        if(visit.find(s->nb)==visit.end()){
-          s=states.erase(s);
-          //Pas besoin de s'occuper des transitions qui viennent à lui puisque soit il n'y en a pas, soit elles proviennent d'un état poubelle qui sera également supprimé
-        }else{
-          s++;
+      Traversal traversal(states.size());
+      int rank=0;
+      for(const State& s : states){
+        if(s.isInit){
+          traversal.addSource(rank);
         }
+        rank++;
       }
-      if(!isValid()){
-        //addState(0);
-      }
+      search(traversal,false,nullptr);
+      removeStatesOutside(traversal.visited());
     }
 
     /**
@@ -636,26 +636,17 @@ namespace fa {
       if(!isValid()){
         return;
       }
-      std::set<int> visit;
-      auto s=states.begin();
-      while(s!=states.end()){
-        if(!s->isFinal){
-          if(DepthSearchEmpty(s,visit)){
-            auto temp=s;
-            s++;
-            removeState(temp->nb);
-          }else{
-            s++;
-          }
-        }else{
-          s++;
+      //one backward search from all the final states
+      Traversal traversal(states.size());
+      int rank=0;
+      for(const State& s : states){
+        if(s.isFinal){
+          traversal.addSource(rank);
         }
-        visit.clear();
+        rank++;
       }
-      if(!isValid()){
-       // addState(0);
-      }
-      
+      search(traversal,true,nullptr);
+      removeStatesOutside(traversal.visited());
     }
 
 
@@ -666,157 +657,7 @@ namespace fa {
      */
     Automaton Automaton::createProduct(const Automaton& lhs, const Automaton& rhs){
       assert(lhs.isValid() && rhs.isValid());
-      Automaton product;
-      product.addState(0);//need a state in any case
-      for(char symb : lhs.alphabet){
-        if(rhs.hasSymbol(symb)){
-          product.addSymbol(symb);
-        }
-      }
-       //if lhs and rhs don't have common letter
-      if(product.countSymbols()<1){
-          product.addSymbol('#');
-      }
-      //Pour la suite, les états de l'automate 2 auront comme nombre i+size ex : l 'état 0 sera 0+size= 4 si l'automate 1 a 4 états.
-      //Cela permettra de différencier les 2 automates avec leurs états avec un if(nb < size)=> automate 1 else automate 2
-      std::map<int,std::vector<int>>tab;
-      std::vector<int>curr1;
-      std::vector<int>curr2;
-      
-      std::vector<int>init1;
-      std::vector<int>init2;
-      for(auto s : lhs.states){
-        if(s.isInit){
-          init1.push_back(s.nb);
-        }
-      }
-      for(auto s : rhs.states){
-        if(s.isInit){
-          init2.push_back(s.nb);
-        }
-      }
-      //if lhs or rhs don't have initial state
-      if(init1.size()<1 || init2.size()<1){
-        return product;
-      }
-      //first state will be initial (build from initial states)
-      product.setStateInitial(0);
-      //make the different peers with the initial states (if number of state initial = 1 by automaton => complexity=1)
-      int num_index=0;
-      for(size_t i=0;i<init2.size();++i){
-        for(size_t i2=0;i2<init1.size();++i2){
-          tab[num_index].push_back(init1[i2]);
-          tab[num_index].push_back(init2[i]);
-          product.addState(num_index);
-          product.setStateInitial(num_index);
-          num_index++;
-        }
-      }
-      auto it=tab.begin();
-      while(it!=tab.end()){
-        for(size_t i=0;i<product.alphabet.size();++i){ 
-          int existInLhs=0;
-          int existInRhs=0;
-          int nb=it->second[0];
-            if(lhs.states.find(nb)==lhs.states.end()){//Never go inside, just a precaution
-              //printf("\nLa ce n'est pas bon du tout\n");
-              return product;
-            }
-            for(auto tr : lhs.states.find(nb)->transitions){
-              if(tr.symbol==product.alphabet[i]){
-                curr1.push_back(tr.to);
-                existInLhs++;
-              }
-            }
-            nb=it->second[1];
-            if(rhs.states.find(nb)==rhs.states.end()){//Never go inside, just a precaution
-              //printf("\nLa ce n'est pas bon du tout\n");
-              return product;
-            }
-            for(auto tr : rhs.states.find(nb)->transitions){
-              if(tr.symbol==product.alphabet[i]){
-                curr2.push_back(tr.to);
-                existInRhs++;
-              }
-            }
-        
-        
-        if(existInLhs>0 && existInRhs>0){
-          if(existInLhs>1 || existInRhs>1){
-            std::map<int,std::vector<int>>temp;
-            int ind=0;
-            int ind2=0;
-            for(auto c : curr1){
-                for(int k=0;k<existInRhs;++k){
-                  temp[ind+k].push_back(c);
-                }
-                ind+=existInRhs;
-            }
-            for(auto c :curr2){
-                int tmp=ind2;
-                for(int k=0;k<existInLhs;++k){
-                  temp[tmp].push_back(c);
-                  tmp+=existInRhs;
-                }
-                ind2++;
-            }
-            for(auto peer : temp){
-              int in=0;
-              int n=tab.size();
-              for(auto t : tab){
-                if(t.second==peer.second){
-                  in=1;
-                  n=t.first;
-                  break;
-                }
-              }
-              
-              if(in==1){
-                product.addTransition(it->first,product.alphabet[i],n);
-              }else{
-                tab[n]=peer.second;
-                product.addState(n);
-                product.addTransition(it->first,product.alphabet[i],n);
-              }
-            }
-            temp.clear();
-          }else{
-            int in=0;
-            int n=tab.size();
-            for(auto t : tab){
-              if(t.second[0]==curr1[0] && t.second[1]==curr2[0]){
-                in=1;
-                n=t.first;
-                break;
-              }
-            }
-            
-            if(in==1){
-              product.addTransition(it->first,product.alphabet[i],n);
-            }else{
-              tab[n].push_back(curr1[0]);
-              tab[n].push_back(curr2[0]);
-              product.addState(n);
-              product.addTransition(it->first,product.alphabet[i],n);
-            }
-          }
-        }          
-        curr1.clear();
-        curr2.clear();
-      }
-      it++;
-    }
-
-      //Search the final state
-      for(auto e : tab){
-        if(lhs.isStateFinal(e.second[0])){
-          if(rhs.isStateFinal(e.second[1])){
-            product.setStateFinal(e.first);
-          }
-        }
-      }
-
-      return product;
+      return thaw(FrozenAutomaton::createProduct(lhs.freeze(),rhs.freeze()));
     }
 
     /**
@@ -837,99 +678,171 @@ namespace fa {
         }
         return true;
       }
-      //std::cout<<"Product\n";
-      double time=0.0;
-      std::clock_t start;
-      start=std::clock();
+      return freeze().hasEmptyIntersectionWith(other.freeze());
+    }
 
-      
-       Automaton product=createProduct(*this,other);
-       time=(std::clock()-start)/(double) CLOCKS_PER_SEC;
-     /* std::cout<<"temps de l'intersection : "<<time<<std::endl;
-      std::cout<<"Product DONE\n";*/
-      if(!product.isValid()){ //Never go inside
-        return true;
+
+
+    /**
+     * Read the string and compute the state set after traversing the automaton
+     */
+    std::set<int> Automaton::readString(const std::string& word) const{
+      const FrozenAutomaton& automaton=frozen();
+      const Bitset reached=automaton.readString(word);
+      std::set<int> res;
+      for(std::size_t s=reached.first();s<reached.size();s=reached.next(s+1)){
+        res.insert(res.end(),automaton.stateName(s));
       }
-      return product.isLanguageEmpty();
+      return res;
     }
 
+    /**
+     * Tell if the word is in the language accepted by the automaton
+     */
+    bool Automaton::match(const std::string& word) const{
+      return matcher().match(word);
+    }
 
+    /**
+     * Matcher of the automaton, built by the first call and kept until the automaton changes
+     */
+    const Matcher& Automaton::matcher() const{
+      if(!cachedMatcher){
+        cachedMatcher=std::make_shared<Matcher>(frozen());
+      }
+      return *cachedMatcher;
+    }
+
+    /**
+     * Frozen automaton kept until the automaton changes
+     */
+    const FrozenAutomaton& Automaton::frozen() const{
+      if(!cachedFrozen){
+        cachedFrozen=std::make_shared<const FrozenAutomaton>(freeze());
+      }
+      return *cachedFrozen;
+    }
+
+    /**
+     * Drop the frozen automaton and the matcher after a change
+     */
+    void Automaton::changed(){
+      cachedFrozen.reset();
+      cachedMatcher.reset();
+    }
+
+    /**
+     * Build the table-driven minimal DFA of the automaton, to run on raw bytes
+     */
+    CompiledDfa Automaton::compile() const{
+      assert(isValid());
+      return CompiledDfa(freeze());
+    }
+
+    /**
+     * Write the automaton in the binary format of saveAutomaton()
+     */
+    bool Automaton::save(const std::string& path) const{
+      assert(isValid());
+      return saveAutomaton(freeze(),path);
+    }
+
+    /**
+     * Read an automaton written by save(). Returns false if the file is not valid
+     */
+    bool Automaton::load(const std::string& path,Automaton& automaton){
+      FrozenAutomaton frozen;
+      if(!loadAutomaton(path,frozen)){
+        return false;
+      }
+      automaton=thaw(frozen);
+      return true;
+    }
 
     /**
      * Create a deterministic automaton, if not already deterministic
      */
     Automaton Automaton::createDeterministic(const Automaton& other){
       assert(other.isValid());
-      Automaton product;
-      product.alphabet=other.alphabet;
-      std::map<int,std::set<int>>tab;
-      std::set<int>curr;
-      product.addState(0);
-      
-      for(auto s : other.states){
-        if(s.isInit){
-          tab[0].insert(s.nb);
-        }
-      }
-      //first state will be initial (build from initial states)
-      product.setStateInitial(0);
+      return thaw(other.freeze().createDeterministic());
+    }
 
-      if(tab[0].empty()){
-        return product;
-      }
-      
-      auto it=tab.begin();
-      while(it!=tab.end()){
-        for(size_t i=0;i<product.alphabet.size();++i){
-          
-          int in=0;
-          for(auto s : it->second){
+    Automaton Automaton::createMinimalMoore(const Automaton& other){
+      assert(other.isValid());
+      return thaw(other.freeze().createMinimalMoore());
+    }
 
-            for(auto tr : other.states.find(s)->transitions){
-                if(tr.symbol==product.alphabet[i]){
-                  curr.insert(tr.to);
-                }
-            }
-          }
-          if(!curr.empty()){
-            for(auto it = tab.begin();it!=tab.end();it++){
-              if(it->second==curr){
-                in=1;
-                break;
-              }
-            }
-            int n=-1;
-            if(in==0){
-              int n=tab.size();
-              tab[n]=curr;
-              product.addState(n);
-              product.addTransition(it->first,product.alphabet[i],n);
-            }else{
-              for(auto snb : tab){
-                if(snb.second==curr){
-                  n=snb.first;
-                }
-              }
-              product.addTransition(it->first,product.alphabet[i],n);
-            }
+    Automaton Automaton::createMinimalHopcroft(const Automaton& other){
+      assert(other.isValid());
+      return thaw(other.freeze().createMinimalHopcroft());
+    }
+
+    Automaton Automaton::createMinimalBrzozowski(const Automaton& other){
+      assert(other.isValid());
+      return thaw(other.freeze().createMinimalBrzozowski());
+    }
+
+    Automaton Automaton::createBisimulationQuotient(const Automaton& other){
+      assert(other.isValid());
+      return thaw(other.freeze().createBisimulationQuotient());
+    }
+
+    Automaton Automaton::createSimulationPruned(const Automaton& other){
+      assert(other.isValid());
+      return thaw(other.freeze().createSimulationPruned());
+    }
+
+    /**
+     * Build the read-only flat representation of the automaton
+     */
+    FrozenAutomaton Automaton::freeze() const{
+      std::vector<int> names;
+      std::vector<unsigned char> flags;
+      names.reserve(states.size());
+      flags.reserve(states.size());
+      for(auto const &s : states){
+        names.push_back(s.nb);
+        flags.push_back((s.isInit ? FrozenAutomaton::Initial : 0) | (s.isFinal ? FrozenAutomaton::Final : 0));
+      }
+      int symbols[256];
+      std::fill(symbols,symbols+256,-1);
+      for(size_t i=0;i<alphabet.size();++i){
+        symbols[static_cast<unsigned char>(alphabet[i])]=i;
+      }
+      std::vector<FrozenAutomaton::Edge> edges;
+      int from=0;
+      for(auto const &s : states){
+        for(auto const &tr : s.transitions){
+          auto to=std::lower_bound(names.begin(),names.end(),tr.to);
+          //epsilon-transitions are not represented
+          if(to==names.end() || *to!=tr.to || symbols[static_cast<unsigned char>(tr.symbol)]<0){
+            continue;
           }
-            
-          
-          curr.clear();
+          edges.push_back(FrozenAutomaton::Edge{from,symbols[static_cast<unsigned char>(tr.symbol)],static_cast<int>(to-names.begin())});
         }
-        
-        it++;
+        from++;
       }
-      //Search the final state
-      for(auto e : tab){
-        for(auto s : e.second){
-          if(other.isStateFinal(s)){
-            product.setStateFinal(e.first);
+      return FrozenAutomaton(alphabet,names,flags,edges);
+    }
+
+    /**
+     * Build a mutable automaton back from a frozen one
+     */
+    Automaton Automaton::thaw(const FrozenAutomaton& frozen){
+      Automaton result;
+      result.alphabet=frozen.alphabet();
+      for(size_t s=0;s<frozen.countStates();++s){
+        State state(frozen.stateName(s));
+        state.isInit=frozen.isInitial(s);
+        state.isFinal=frozen.isFinal(s);
+        for(size_t a=0;a<frozen.countSymbols();++a){
+          for(int to : frozen.successors(s,a)){
+            state.transitions.insert(Transition(state.nb,frozen.symbol(a),frozen.stateName(to)));
           }
         }
+        result.states.insert(result.states.end(),state);
       }
-
-      return product;
+      return result;
     }
 
     /**
@@ -937,7 +850,28 @@ namespace fa {
      * language accepted by the other automaton
      */
     bool Automaton::isIncludedIn(const Automaton& other) const{
+      return isIncludedIn(other,InclusionEngine::Complement);
+    }
+
+    /**
+     * Tell if the langage accepted by the automaton is included in the
+     * language accepted by the other automaton, with the chosen algorithm
+     */
+    bool Automaton::isIncludedIn(const Automaton& other,InclusionEngine engine) const{
+      return isIncludedIn(other,engine,Minimization::Hopcroft);
+    }
+
+    /**
+     * Same, the complement engine minimizes the other automaton with the chosen algorithm
+     */
+    bool Automaton::isIncludedIn(const Automaton& other,InclusionEngine engine,Minimization minimization) const{
       assert(other.isValid());
+      if(engine==InclusionEngine::Antichain){
+        return isIncludedAntichain(freeze(),other.freeze());
+      }
+      if(engine==InclusionEngine::Hkc){
+        return isIncludedHkc(freeze(),other.freeze());
+      }
 
       if(!isValid()){
         if(isLanguageEmpty()){
@@ -954,7 +888,8 @@ namespace fa {
       double time=0.0;
       std::clock_t start;
       start=std::clock(); 
-      Automaton complement=createComplement(copy);
+      //the minimal DFA is complete, the complement only swaps the final states
+      Automaton complement=createComplement(thaw(copy.freeze().createMinimal(minimization)));
       time=(std::clock()-start)/(double) CLOCKS_PER_SEC;
      /* std::cout<<"temps pour la déterminisation: "<<time<<std::endl;
       std::cout<<"Création du complément DONE\n";*/
@@ -964,6 +899,21 @@ namespace fa {
       return deter.hasEmptyIntersectionWith(complement);
     }
 
+    /**
+     * Tell if the langage accepted by the automaton is not included in the
+     * language accepted by the other automaton, and give the shortest witness
+     */
+    bool Automaton::findCounterexample(const Automaton& other,std::string& word) const{
+      return fa::findCounterexample(freeze(),other.freeze(),word);
+    }
+
+    /**
+     * Tell if the automaton and the other one accept the same language
+     */
+    bool Automaton::isEquivalentTo(const Automaton& other) const{
+      return isEquivalentHkc(freeze(),other.freeze());
+    }
+
 }
 
 using namespace std;
@@ -1035,19 +985,51 @@ int main(int argc, char **argv){
       // A1.addState(0);A1.addState(1);
       // A1.addState(2);A1.addState(3);
 
-      if(argc>2){
-      srand(atoi(argv[2]));
+      //options start with "--", the others are positional : nbStates seed
+      fa::InclusionEngine engine=fa::InclusionEngine::Complement;
+      fa::Minimization minimization=fa::Minimization::Hopcroft;
+      bool witness=false;
+      std::vector<char*> args;
+      for(int i=1;i<argc;++i){
+        if(strcmp(argv[i],"--antichain")==0){
+          engine=fa::InclusionEngine::Antichain;
+        }else if(strcmp(argv[i],"--witness")==0){
+          witness=true;
+        }else if(strcmp(argv[i],"--hkc")==0){
+          engine=fa::InclusionEngine::Hkc;
+        }else if(strcmp(argv[i],"--complement")==0){
+          engine=fa::InclusionEngine::Complement;
+        }else if(strcmp(argv[i],"--minimal=hopcroft")==0){
+          minimization=fa::Minimization::Hopcroft;
+        }else if(strcmp(argv[i],"--minimal=moore")==0){
+          minimization=fa::Minimization::Moore;
+        }else if(strcmp(argv[i],"--minimal=brzozowski")==0){
+          minimization=fa::Minimization::Brzozowski;
+        }else{
+          args.push_back(argv[i]);
+        }
+      }
+
+      if(args.size()>1){
+      srand(atoi(args[1]));
     }else{
       srand(time(NULL));
     }
     int nbStates=10;
-    if(argc>1){
-      nbStates=stoi(argv[1]);
+    if(args.size()>0){
+      nbStates=stoi(args[0]);
     }
     //printf("nb : %d\n",nbStates);
   fa::Automaton A2=RandomAutomaton(nbStates);
   //A2.dotPrint(std::cout);
-    if(A1.isIncludedIn(A2)){
+    std::string word;
+    if(witness){
+      if(A1.findCounterexample(A2,word)){
+        printf("A1 is Not included\nCounterexample : \"%s\"\n",word.c_str());
+      }else{
+        printf("A1 is Included\n");
+      }
+    }else if(A1.isIncludedIn(A2,engine,minimization)){
         printf("A1 is Included\n");
     }else{
         printf("A1 is Not included\n");
@@ -0,0 +1,83 @@
+#ifndef TRAVERSAL_H
+#define TRAVERSAL_H
+
+#include <cstddef>
+#include <vector>
+#include "Bitset.h"
+
+namespace fa {
+
+  /**
+   * Breadth-first search over state indices 0..n-1, without recursion.
+   *
+   * The graph is given to run() as a function neighbours(state,add) calling
+   * add(next) for each next state: successors for a forward search, predecessors
+   * for a backward one. Several sources can be added, before or between runs.
+   * The visited set is kept until clear(), which only resets the visited states,
+   * so one Traversal can serve many searches on the same automaton.
+   */
+  class Traversal {
+  public:
+    explicit Traversal(std::size_t countStates) : visit(countStates),head(0) {}
+
+    /**
+     * Forget the visited states and the pending sources
+     */
+    void clear(){
+      for(int s : order){
+        visit.reset(s);
+      }
+      order.clear();
+      head=0;
+    }
+
+    /**
+     * Visit the state, unless it is already visited
+     */
+    void addSource(int state){
+      if(!visit.test(state)){
+        visit.set(state);
+        order.push_back(state);
+      }
+    }
+
+    /**
+     * Visit the states reachable from the sources. Stops at the first state for
+     * which stop(state) is true, before adding its neighbours, and returns it.
+     * Returns -1 once every reachable state is visited.
+     */
+    template<typename Neighbours,typename Stop>
+    int run(Neighbours neighbours,Stop stop){
+      auto add=[this](int next){ addSource(next); };
+      while(head<order.size()){
+        const int state=order[head++];
+        if(stop(state)){
+          return state;
+        }
+        neighbours(state,add);
+      }
+      return -1;
+    }
+
+    template<typename Neighbours>
+    void run(Neighbours neighbours){
+      run(neighbours,[](int){ return false; });
+    }
+
+    const Bitset& visited() const { return visit; }
+    bool isVisited(int state) const { return visit.test(state); }
+
+    /**
+     * Visited states, in the order of their visit
+     */
+    const std::vector<int>& visitOrder() const { return order; }
+
+  private:
+    Bitset visit;
+    std::vector<int> order;
+    std::size_t head;
+  };
+
+}
+
+#endif // TRAVERSAL_H
@@ -3,5 +3,7 @@
 # fake makefile
 # chmod +x make.sh
 # ./make.sh
-g++ TestsAutomaton.cc -o TestsAutomaton
-g++ Automaton.cc -o Automaton
\ No newline at end of file
+g++ TestsAutomaton.cc FrozenAutomaton.cc SuccessorMasks.cc Matcher.cc CompiledDfa.cc AutomatonFile.cc Inclusion.cc -o TestsAutomaton
+g++ Automaton.cc FrozenAutomaton.cc SuccessorMasks.cc Matcher.cc CompiledDfa.cc AutomatonFile.cc Inclusion.cc SatSolver.cc DimacsWriter.cc Cardinality.cc InclusionEncoder.cc -o Automaton
+# ./SelfCheck compares the engines with brute force on small random automata
+g++ SelfCheck.cc FrozenAutomaton.cc SuccessorMasks.cc Matcher.cc CompiledDfa.cc AutomatonFile.cc Inclusion.cc SatSolver.cc DimacsWriter.cc Cardinality.cc InclusionEncoder.cc -o SelfCheck
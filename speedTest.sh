@@ -4,6 +4,15 @@
 # ./speedTest.sh  --SAT nbExec nbStates maxLength (rand || nb)
 # ./speedTest.sh --DET nbExec nbStates (rand || nb)
 # nb : for srand
+# ENGINE=--antichain ./speedTest.sh --DET ... : inclusion algorithm of TestsAutomaton (--complement by default, --antichain or --hkc)
+#   ENGINE="--complement --minimal=brzozowski" : minimal DFA complemented by the complement engine (--minimal=hopcroft by default, moore or brzozowski)
+# SOLVER=embedded ./speedTest.sh --SAT ... : solve in the process with Automaton --SOLVE instead of minisat
+# SOLVER=incremental ./speedTest.sh --SAT ... : one Automaton --INCREMENTAL run for all the lengths, from 1 like the other solvers
+# SOLVER=hkc ./speedTest.sh --SAT ... : decide the inclusion with Automaton --INCLUSION --engine=hkc, without length bound (complement, antichain or hkc)
+# AMO=--amo=sequential ./speedTest.sh --SAT ... : at-most-one encoding of the clauses (pairwise by default, sequential, commander, product, binary or bimander)
+#   AMO="--amo=sequential --letters=log" also writes the letters in binary (--letters=onehot by default)
+#   AMO="--no-trim" keeps the states that cannot be on a run of the length (trimmed by default)
+#   AMO="--no-reduce" encodes A1 and A2 as generated (by default A1 is pruned with its simulation and A2 quotiented by its bisimulation)
 
 if [ $# -ne 3 ] && [ $# -ne 4 ] && [ $# -ne 5 ]
 then
@@ -45,21 +54,83 @@ if [ "--SAT" = $1 ]
 then 
     for i in $(seq $2) #number of executions -> to the random seed
     do
+        if [ "$SOLVER" == "complement" ] || [ "$SOLVER" == "antichain" ] || [ "$SOLVER" == "hkc" ]
+        then
+            if [ $# -ne 5 ]
+            then
+                seed=$i
+            elif [ $5 == "rand" ]
+            then
+                seed=""
+            else
+                seed=$[$i+$5]
+            fi
+            if [ "$(./Automaton --INCLUSION $3 $seed --engine=$SOLVER $AMO)" == "A1 is included in A2" ]
+            then
+                echo 'Automate is Included'
+            else
+                echo 'Automate is Not included'
+            fi
+            continue
+        fi
+        if [ "$SOLVER" == "incremental" ]
+        then
+            if [ $# -ne 5 ]
+            then
+                seed=$i
+            elif [ $5 == "rand" ]
+            then
+                seed=""
+            else
+                seed=$[$i+$5]
+            fi
+            output=$(./Automaton --INCREMENTAL $4 $3 $seed $AMO)
+            status=$?
+            if [ $status -eq 0 ]
+            then
+                word=$(echo "$output" | head -n 1)
+                echo ${#word}
+            elif [ $status -eq 1 ]
+            then
+                echo 'Automate is Included'
+            else
+                echo "$output"
+                exit 1
+            fi
+            continue
+        fi
         for j in $(seq $4) #max length
         do
             if [ $# -ne 5 ]
             then
-                ./Automaton --SAT $j $3 $i  #$i = seed
+                seed=$i  #$i = seed
             else
                 if [ $5 == "rand" ]   #$j = word's length
                 then                  #$3 = number of state of A2
-                    ./Automaton --SAT $j $3
+                    seed=""
+                else
+                    seed=$[$i+$5]        #$[$i+$5] = seed
+                fi
+            fi
+            if [ "$SOLVER" == "embedded" ]
+            then
+                output=$(./Automaton --SOLVE $j $3 $seed $AMO)
+                status=$?
+                if [ $status -eq 0 ]
+                then
+                    line="SAT"
+                elif [ $status -eq 1 ]
+                then
+                    line="UNSAT"
                 else
-                    ./Automaton --SAT $j $3 $[$i+$5]        #$[$i+$5] = seed
+                    echo "$output"
+                    exit 1
                 fi
+            else
+                ./Automaton --SAT $j $3 $seed $AMO
+                minisat Automaton.cnf Automaton.out &>/dev/null
+                line=$(head -n 1 Automaton.out)
             fi
-            minisat Automaton.cnf Automaton.out &>/dev/null
-            line=$(head -n 1 Automaton.out)
             if [ "SAT" == $line ]
             then
             echo $j
@@ -76,13 +147,13 @@ else #--DET
     do
         if [ $# -ne 4 ]
         then
-            ./TestsAutomaton $3 $i
+            ./TestsAutomaton $3 $i $ENGINE
         else
             if [ $4 == "rand" ]
             then
-                ./TestsAutomaton $3 
+                ./TestsAutomaton $3 $ENGINE
             else
-                ./TestsAutomaton $3 $[$i+$4]
+                ./TestsAutomaton $3 $[$i+$4] $ENGINE
             fi
         fi
     done